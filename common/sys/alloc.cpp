@@ -275,6 +275,10 @@ namespace embree
   void os_advise(void *ptr, size_t bytes)
   {
   }
+
+  void os_bind_numa(void* ptr, size_t bytes, unsigned int node)
+  {
+  }
 }
 
 #endif
@@ -287,6 +291,10 @@ namespace embree
 
 #include <sys/mman.h>
 #include <errno.h>
+#if defined(__LINUX__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 #include <sstream>
@@ -412,6 +420,24 @@ namespace embree
   {
 #if defined(MADV_HUGEPAGE)
     madvise(pptr,bytes,MADV_HUGEPAGE); 
+#endif
+  }
+
+  /* prefers pages of the range to reside on some NUMA node, already touched pages get migrated */
+  void os_bind_numa(void* pptr, size_t bytes, unsigned int node)
+  {
+#if defined(__LINUX__) && defined(SYS_mbind)
+    const int MPOL_PREFERRED = 1;
+    const unsigned MPOL_MF_MOVE = 1 << 1;
+    if (node >= 8*sizeof(unsigned long)) return;
+
+    /* mbind only operates on full pages inside the range */
+    const size_t begin = ((size_t)pptr+PAGE_SIZE_4K-1) & ~size_t(PAGE_SIZE_4K-1);
+    const size_t end = ((size_t)pptr+bytes) & ~size_t(PAGE_SIZE_4K-1);
+    if (end <= begin) return;
+
+    const unsigned long nodemask = 1ul << node;
+    syscall(SYS_mbind,(void*)begin,end-begin,MPOL_PREFERRED,&nodemask,8*sizeof(nodemask),MPOL_MF_MOVE);
 #endif
   }
 }
@@ -112,6 +112,7 @@ namespace embree
   size_t os_shrink (void* ptr, size_t bytesNew, size_t bytesOld, bool hugepages);
   void  os_free   (void* ptr, size_t bytes, bool hugepages);
   void  os_advise (void* ptr, size_t bytes);
+  void  os_bind_numa (void* ptr, size_t bytes, unsigned int node);
 
   /*! allocator that performs OS allocations */
   template<typename T>
@@ -539,6 +539,7 @@ namespace embree
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/syscall.h>
 
 namespace embree
 {
@@ -567,6 +568,55 @@ namespace embree
     buffer >> virt >> resident >> shared;
     return resident*sysconf(_SC_PAGE_SIZE);
   }
+
+  unsigned int getNumberOfNumaNodes()
+  {
+    static int nNodes = -1;
+    if (nNodes != -1) return nNodes;
+
+    /* the online node list has the form "0" or "0-1" or "0,2-3" */
+    nNodes = 1;
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string line;
+    if (file.is_open() && getline(file,line))
+    {
+      for (size_t i=0; i<line.size();)
+      {
+        if (!isdigit(line[i])) { i++; continue; }
+        size_t end = i; while (end < line.size() && isdigit(line[end])) end++;
+        nNodes = max(nNodes,std::stoi(line.substr(i,end-i))+1);
+        i = end;
+      }
+    }
+    return nNodes;
+  }
+
+  unsigned int getNumaNode()
+  {
+    unsigned int cpu = 0, node = 0;
+    if (syscall(SYS_getcpu,&cpu,&node,nullptr) != 0)
+      return 0;
+    return node;
+  }
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// Platforms without NUMA support
+////////////////////////////////////////////////////////////////////////////////
+
+#if !defined(__LINUX__)
+
+namespace embree
+{
+  unsigned int getNumberOfNumaNodes() {
+    return 1;
+  }
+
+  unsigned int getNumaNode() {
+    return 0;
+  }
 }
 
 #endif
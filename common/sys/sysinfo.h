@@ -170,6 +170,12 @@ namespace embree
   /*! return the number of logical threads of the system */
   unsigned int getNumberOfLogicalThreads();
 
+  /*! returns the number of NUMA nodes of the system */
+  unsigned int getNumberOfNumaNodes();
+
+  /*! returns the NUMA node the calling thread currently runs on */
+  unsigned int getNumaNode();
+
   /*! returns the size of the terminal window in characters */
   int getTerminalWidth();
 
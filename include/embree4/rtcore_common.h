@@ -334,6 +334,9 @@ struct RTCRayQueryContext
   unsigned int instStackSize;                        // Number of instances currently on the stack.
 #endif
   unsigned int instID[RTC_MAX_INSTANCE_LEVEL_COUNT]; // The current stack of instance ids.
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  unsigned int instPrimID[RTC_MAX_INSTANCE_LEVEL_COUNT]; // The current stack of instance primitive ids.
+#endif
 };
 
 /* Initializes an ray query context. */
@@ -345,8 +348,12 @@ RTC_FORCEINLINE void rtcInitRayQueryContext(struct RTCRayQueryContext* context)
   context->instStackSize = 0;
 #endif
 
-  for (; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+  for (; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
     context->instID[l] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    context->instPrimID[l] = RTC_INVALID_GEOMETRY_ID;
+#endif
+  }
 }
 
 /* Point query structure for closest point query */
@@ -404,6 +411,11 @@ struct RTC_ALIGN(16) RTCPointQueryContext
   // instance ids.
   unsigned int instID[RTC_MAX_INSTANCE_LEVEL_COUNT];
 
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  // instance prim ids.
+  unsigned int instPrimID[RTC_MAX_INSTANCE_LEVEL_COUNT];
+#endif
+
   // number of instances currently on the stack.
   unsigned int instStackSize;
 };
@@ -413,6 +425,9 @@ RTC_FORCEINLINE void rtcInitPointQueryContext(struct RTCPointQueryContext* conte
 {
   context->instStackSize = 0;
   context->instID[0] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  context->instPrimID[0] = RTC_INVALID_GEOMETRY_ID;
+#endif
 }
 
 struct RTC_ALIGN(16) RTCPointQueryFunctionArguments
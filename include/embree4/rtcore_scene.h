@@ -12,6 +12,7 @@ struct RTCRayHit;
 struct RTCRayHit4;
 struct RTCRayHit8;
 struct RTCRayHit16;
+struct RTCHit;
 
 /* Scene flags */
 enum RTCSceneFlags
@@ -23,6 +24,15 @@ enum RTCSceneFlags
   RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS = (1 << 3)
 };
 
+/* Hit buffer that receives the closest hits of a multi-hit query */
+struct RTCMultiHit
+{
+  unsigned int maxHits;   // number of hits to collect, capacity of the t and hits arrays
+  unsigned int numHits;   // number of collected hits, set by rtcIntersect1
+  float* t;               // hit distances sorted front to back
+  struct RTCHit* hits;    // hit data in the order of the hit distances
+};
+
 /* Additional arguments for rtcIntersect1/4/8/16 calls */
 struct RTCIntersectArguments
 {
@@ -34,6 +44,7 @@ struct RTCIntersectArguments
 #if RTC_MIN_WIDTH
   float minWidthDistanceFactor;            // curve radius is set to this factor times distance to ray origin
 #endif
+  struct RTCMultiHit* multiHit;            // optional buffer to collect the closest hits of a single ray
 };
 
 /* Initializes intersection arguments. */
@@ -48,6 +59,7 @@ RTC_FORCEINLINE void rtcInitIntersectArguments(struct RTCIntersectArguments* arg
 #if RTC_MIN_WIDTH
   args->minWidthDistanceFactor = 0.0f;
 #endif
+  args->multiHit = NULL;
 }
 
 /* Additional arguments for rtcOccluded1/4/8/16 calls */
@@ -117,6 +129,36 @@ RTC_API void rtcCommitScene(RTCScene scene);
 /* Commits the scene from multiple threads. */
 RTC_API void rtcJoinCommitScene(RTCScene scene);
 
+/* Handle of an asynchronous scene commit */
+typedef struct RTCSceneCommitTy* RTCSceneCommit;
+
+/* Callback invoked from the build thread when an asynchronous commit finished */
+typedef void (*RTCSceneCommitFunction)(void* userPtr, enum RTCError error);
+
+/* Commits the scene on a background thread and returns a handle to poll, wait for, or cancel the commit. */
+RTC_API RTCSceneCommit rtcCommitSceneAsync(RTCScene scene, RTCSceneCommitFunction func, void* userPtr);
+
+/* Returns true if the asynchronous commit finished. */
+RTC_API bool rtcIsSceneCommitDone(RTCSceneCommit commit);
+
+/* Waits for the asynchronous commit to finish and returns its error code. */
+RTC_API enum RTCError rtcWaitSceneCommit(RTCSceneCommit commit);
+
+/* Requests cancellation of the asynchronous commit. */
+RTC_API void rtcCancelSceneCommit(RTCSceneCommit commit);
+
+/* Retains the asynchronous commit handle (increments the reference count). */
+RTC_API void rtcRetainSceneCommit(RTCSceneCommit commit);
+
+/* Releases the asynchronous commit handle (decrements the reference count), waits for the commit to finish when the last reference is released. */
+RTC_API void rtcReleaseSceneCommit(RTCSceneCommit commit);
+
+/* Stores the acceleration structure of a committed scene into a file. */
+RTC_API void rtcSaveSceneBVH(RTCScene scene, const char* filename);
+
+/* Commits the scene by loading its acceleration structure from a file, returns false if the file does not match the scene. */
+RTC_API bool rtcLoadSceneBVH(RTCScene scene, const char* filename);
+
 
 /* Progress monitor callback function */
 typedef bool (*RTCProgressMonitorFunction)(void* ptr, double n);
@@ -139,6 +181,21 @@ RTC_API void rtcGetSceneBounds(RTCScene scene, struct RTCBounds* bounds_o);
 /* Returns the linear axis-aligned bounds of the scene. */
 RTC_API void rtcGetSceneLinearBounds(RTCScene scene, struct RTCLinearBounds* bounds_o);
 
+/* Memory statistics of one acceleration structure of a scene */
+struct RTCSceneMemoryStatistics
+{
+  size_t nodeBytes;   // bytes used by inner nodes
+  size_t leafBytes;   // bytes used by leaf primitives
+  size_t freeBytes;   // bytes allocated but not used
+  size_t wastedBytes; // bytes lost to block headers and alignment
+};
+
+/* Sets the maximal number of bytes the acceleration structures of the scene may allocate, 0 disables the budget. */
+RTC_API void rtcSetSceneMemoryBudget(RTCScene scene, size_t bytes);
+
+/* Gets the memory statistics of each acceleration structure of a committed scene, returns the number of acceleration structures. */
+RTC_API size_t rtcGetSceneMemoryStatistics(RTCScene scene, struct RTCSceneMemoryStatistics* stats, size_t maxStats);
+
 
 /* Perform a closest point query of the scene. */
 RTC_API bool rtcPointQuery(RTCScene scene, struct RTCPointQuery* query, struct RTCPointQueryContext* context, RTCPointQueryFunction queryFunc, void* userPtr);
@@ -165,6 +222,12 @@ RTC_API void rtcIntersect8(const int* valid, RTCScene scene, struct RTCRayHit8*
 /* Intersects a packet of 16 rays with the scene. */
 RTC_API void rtcIntersect16(const int* valid, RTCScene scene, struct RTCRayHit16* rayhit, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
 
+/* Intersects a stream of M rays in AOS layout with the scene. */
+RTC_API void rtcIntersect1M(RTCScene scene, struct RTCRayHit* rayhit, unsigned int M, size_t byteStride, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Intersects a stream of N rays in pointer SOA layout with the scene. */
+RTC_API void rtcIntersectNp(RTCScene scene, const struct RTCRayHitNp* rayhit, unsigned int N, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
 
 /* Forwards ray inside user geometry callback. */
 RTC_SYCL_API void rtcForwardIntersect1(const struct RTCIntersectFunctionNArguments* args, RTCScene scene, struct RTCRay* ray, unsigned int instID);
@@ -191,6 +254,12 @@ RTC_API void rtcOccluded8(const int* valid, RTCScene scene, struct RTCRay8* ray,
 /* Tests a packet of 16 rays for occlusion with the scene. */
 RTC_API void rtcOccluded16(const int* valid, RTCScene scene, struct RTCRay16* ray, struct RTCOccludedArguments* args RTC_OPTIONAL_ARGUMENT);
 
+/* Tests a stream of M rays in AOS layout for occlusion with the scene. */
+RTC_API void rtcOccluded1M(RTCScene scene, struct RTCRay* ray, unsigned int M, size_t byteStride, struct RTCOccludedArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Tests a stream of N rays in pointer SOA layout for occlusion with the scene. */
+RTC_API void rtcOccludedNp(RTCScene scene, const struct RTCRayNp* ray, unsigned int N, struct RTCOccludedArguments* args RTC_OPTIONAL_ARGUMENT);
+
 
 /* Forwards single occlusion ray inside user geometry callback. */
 RTC_SYCL_API void rtcForwardOccluded1(const struct RTCOccludedFunctionNArguments* args, RTCScene scene, struct RTCRay* ray, unsigned int instID);
@@ -209,8 +278,29 @@ RTC_API void rtcForwardOccluded16(const int* valid, const struct RTCOccludedFunc
 struct RTCCollision { unsigned int geomID0; unsigned int primID0; unsigned int geomID1; unsigned int primID1; };
 typedef void (*RTCCollideFunc) (void* userPtr, struct RTCCollision* collisions, unsigned int num_collisions);
 
+/* Collision flags */
+enum RTCCollideFlags
+{
+  RTC_COLLIDE_FLAG_NONE     = 0,
+  RTC_COLLIDE_FLAG_BUFFERED = (1 << 0)  // buffer collisions per thread and report them in large batches
+};
+
+/* Additional arguments for rtcCollide calls */
+struct RTCCollideArguments
+{
+  enum RTCCollideFlags flags;  // collision flags
+  unsigned int batchSize;      // number of collisions reported per callback invocation in buffered mode
+};
+
+/* Initializes collision arguments. */
+RTC_FORCEINLINE void rtcInitCollideArguments(struct RTCCollideArguments* args)
+{
+  args->flags = RTC_COLLIDE_FLAG_NONE;
+  args->batchSize = 4096;
+}
+
 /*! Performs collision detection of two scenes */
-RTC_API void rtcCollide (RTCScene scene0, RTCScene scene1, RTCCollideFunc callback, void* userPtr);
+RTC_API void rtcCollide (RTCScene scene0, RTCScene scene1, RTCCollideFunc callback, void* userPtr, struct RTCCollideArguments* args RTC_OPTIONAL_ARGUMENT);
  
 #if defined(__cplusplus)
 
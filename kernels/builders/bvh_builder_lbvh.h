@@ -0,0 +1,362 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "priminfo.h"
+#include "../../common/algorithms/parallel_for.h"
+#include "../../common/algorithms/parallel_sort.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /* Linear BVH builder over 63 bit Morton codes (Karras 2012). The
+     * primitives get sorted by a parallel radix sort over the codes,
+     * then all inner nodes of the binary radix tree over the sorted
+     * codes are created in parallel, and bounds and user nodes get
+     * emitted bottom up, where the second thread arriving at a node
+     * processes it. Equal codes get resolved by the primitive index,
+     * thus clustered geometry still produces a tree of logarithmic
+     * depth. Optionally, treelets of 7 leaves get restructured for
+     * minimal SAH cost in multiple bottom up passes (Karras and Aila
+     * 2013), which recovers most of the quality of a SAH builder. */
+    struct BVHBuilderLBVH
+    {
+      /*! number of primitives processed by a task */
+      static const size_t BLOCK_SIZE = 1024;
+
+      /*! number of leaves of a restructured treelet */
+      static const size_t TREELET_LEAVES = 7;
+
+      /*! number of treelet restructuring passes for high quality builds */
+      static const size_t DEFAULT_TREELET_ITERATIONS = 3;
+
+      /*! settings for the LBVH builder */
+      struct Settings
+      {
+        Settings ()
+          : travCost(1.0f), intCost(1.0f), treeletIterations(0) {}
+
+        Settings (float travCost, float intCost, size_t treeletIterations)
+          : travCost(travCost), intCost(intCost), treeletIterations(treeletIterations) {}
+
+      public:
+        float travCost;           //!< SAH cost of traversing a binary node
+        float intCost;            //!< SAH cost of intersecting a primitive
+        size_t treeletIterations; //!< number of treelet restructuring passes, 0 disables restructuring
+      };
+
+      /*! Build primitive consisting of 63 bit morton code and primitive ID. */
+      struct __aligned(16) BuildPrim
+      {
+        uint64_t code;       //!< morton code
+        unsigned int index;  //!< i'th primitive
+
+        /*! interface for radix sort */
+        __forceinline operator uint64_t() const { return code; }
+      };
+
+      /*! maps bounding box to 63 bit morton code */
+      struct MortonCodeMapping
+      {
+        static const size_t LATTICE_BITS_PER_DIM = 21;
+        static const size_t LATTICE_SIZE_PER_DIM = size_t(1) << LATTICE_BITS_PER_DIM;
+
+        vfloat4 base;
+        vfloat4 scale;
+
+        __forceinline MortonCodeMapping(const BBox3fa& bounds)
+        {
+          base  = (vfloat4)bounds.lower;
+          const vfloat4 diag  = (vfloat4)bounds.upper - (vfloat4)bounds.lower;
+          scale = select(diag > vfloat4(1E-19f), rcp(diag) * vfloat4(LATTICE_SIZE_PER_DIM * 0.99f),vfloat4(0.0f));
+        }
+
+        __forceinline uint64_t code (const BBox3fa& box) const
+        {
+          const vfloat4 lower = (vfloat4)box.lower;
+          const vfloat4 upper = (vfloat4)box.upper;
+          const vfloat4 centroid = lower+upper;
+          const vint4 binID = vint4((centroid-base)*scale);
+          const uint64_t x = extract<0>(binID);
+          const uint64_t y = extract<1>(binID);
+          const uint64_t z = extract<2>(binID);
+          return bitInterleave64(x,y,z);
+        }
+      };
+
+      template<typename ReductionTy, typename CreateLeafFunc, typename CreateNodeFunc>
+      class BuilderT
+      {
+        static const unsigned int invalidNode = 0xFFFFFFFF;
+
+      public:
+
+        BuilderT (const CreateLeafFunc& createLeaf, const CreateNodeFunc& createNode, const Settings& settings)
+          : createLeaf(createLeaf), createNode(createNode), settings(settings), n(0) {}
+
+        /*! sorts the primitives along the Morton curve and builds the binary BVH over them */
+        ReductionTy build(PrimRef* prims, const PrimInfo& pinfo)
+        {
+          n = pinfo.size();
+          if (n == 1) return createLeaf(prims,0);
+
+          sort(prims,pinfo);
+
+          /* inner nodes are stored first, followed by one leaf per primitive */
+          const size_t numNodes = 2*n-1;
+          left.resize(n-1); right.resize(n-1);
+          parent.resize(numNodes);
+          bounds.resize(numNodes); cost.resize(numNodes); size.resize(numNodes);
+          std::vector<std::atomic<unsigned int>> counters0(n-1);
+          counters.swap(counters0);
+
+          /* create all inner nodes of the radix tree in parallel */
+          parent[0] = invalidNode;
+          parallel_for(size_t(0), n-1, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+                createInnerNode(i);
+            });
+
+          parallel_for(size_t(0), n, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                const unsigned int leaf = leafNode(i);
+                bounds[leaf] = prims[i].bounds();
+                cost[leaf] = settings.intCost*halfArea(bounds[leaf]);
+                size[leaf] = 1;
+              }
+            });
+
+          /* compute the bounds bottom up, optionally restructuring treelets on the way up */
+          const size_t numPasses = max(settings.treeletIterations,size_t(1));
+          for (size_t pass=0; pass<numPasses; pass++)
+          {
+            const size_t minTreeletSize = TREELET_LEAVES << pass;
+            bottomUp([&] (unsigned int node) {
+                refit(node);
+                if (settings.treeletIterations && size[node] >= minTreeletSize)
+                  restructure(node);
+              });
+          }
+
+          /* emit the user nodes bottom up */
+          avector<ReductionTy> values(numNodes);
+          parallel_for(size_t(0), n, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+                values[leafNode(i)] = createLeaf(prims,i);
+            });
+          bottomUp([&] (unsigned int node) {
+              values[node] = createNode(values[left[node]],values[right[node]],bounds[node]);
+            });
+          return values[0];
+        }
+
+      private:
+
+        __forceinline unsigned int leafNode(size_t i) const { return (unsigned int)(n-1+i); }
+        __forceinline bool isLeaf(unsigned int node) const { return node >= n-1; }
+
+        /*! sorts the primitives by the Morton code of their centroid */
+        void sort(PrimRef* prims, const PrimInfo& pinfo)
+        {
+          avector<BuildPrim> morton(n), tmp(n);
+          const MortonCodeMapping mapping(pinfo.centBounds);
+          parallel_for(size_t(0), n, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                morton[i].code = mapping.code(prims[i].bounds());
+                morton[i].index = (unsigned int) i;
+              }
+            });
+          radix_sort_u64(morton.data(),tmp.data(),n);
+
+          avector<PrimRef> sorted(n);
+          codes.resize(n);
+          parallel_for(size_t(0), n, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                sorted[i] = prims[morton[i].index];
+                codes[i] = morton[i].code;
+              }
+            });
+          parallel_for(size_t(0), n, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+                prims[i] = sorted[i];
+            });
+        }
+
+        /*! length of the common prefix of two keys, equal codes get extended by the primitive index */
+        __forceinline int delta(ssize_t i, ssize_t j) const
+        {
+          if (j < 0 || j >= (ssize_t)n) return -1;
+          const uint64_t a = codes[i], b = codes[j];
+          if (a != b) return 63-(int)bsr(size_t(a^b));
+          return 64+63-(int)bsr(size_t(i^j));
+        }
+
+        /*! determines the key range and split position of the i'th inner node */
+        void createInnerNode(ssize_t i)
+        {
+          /* direction and maximal length of the range */
+          const ssize_t d = delta(i,i+1) > delta(i,i-1) ? 1 : -1;
+          const int dmin = delta(i,i-d);
+          ssize_t lmax = 2;
+          while (delta(i,i+lmax*d) > dmin) lmax *= 2;
+
+          /* other end of the range by binary search */
+          ssize_t l = 0;
+          for (ssize_t t=lmax/2; t>=1; t/=2)
+            if (delta(i,i+(l+t)*d) > dmin) l += t;
+          const ssize_t j = i+l*d;
+
+          /* split position by binary search */
+          const int dnode = delta(i,j);
+          ssize_t s = 0;
+          for (ssize_t div=2; ; div*=2) {
+            const ssize_t t = (l+div-1)/div;
+            if (delta(i,i+(s+t)*d) > dnode) s += t;
+            if (t == 1) break;
+          }
+          const ssize_t gamma = i+s*d+min(d,ssize_t(0));
+
+          left [i] = min(i,j)   == gamma   ? leafNode(gamma)   : (unsigned int) gamma;
+          right[i] = max(i,j)   == gamma+1 ? leafNode(gamma+1) : (unsigned int) (gamma+1);
+          parent[left[i]] = parent[right[i]] = (unsigned int) i;
+        }
+
+        /*! processes each inner node after both of its children got processed */
+        template<typename Func>
+        void bottomUp(const Func& func)
+        {
+          parallel_for(size_t(0), n-1, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+                counters[i].store(0);
+            });
+
+          parallel_for(size_t(0), n, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+              {
+                /* the first thread arriving at a node terminates, the second one processes the node */
+                for (unsigned int node = parent[leafNode(i)]; node != invalidNode; node = parent[node])
+                {
+                  if (counters[node]++ == 0) break;
+                  func(node);
+                }
+              }
+            });
+        }
+
+        __forceinline void refit(unsigned int node)
+        {
+          const unsigned int l = left[node], r = right[node];
+          bounds[node] = merge(bounds[l],bounds[r]);
+          cost[node] = settings.travCost*halfArea(bounds[node]) + cost[l] + cost[r];
+          size[node] = size[l] + size[r];
+        }
+
+        /*! replaces the topology of the treelet below the node by the one of minimal SAH cost */
+        void restructure(unsigned int root)
+        {
+          /* grow the treelet by always expanding the leaf of largest surface area */
+          unsigned int leaves[TREELET_LEAVES];
+          unsigned int inner[TREELET_LEAVES-2];
+          size_t numLeaves = 2, numInner = 0;
+          leaves[0] = left[root]; leaves[1] = right[root];
+          while (numLeaves < TREELET_LEAVES)
+          {
+            ssize_t best = -1;
+            float bestArea = neg_inf;
+            for (size_t i=0; i<numLeaves; i++)
+            {
+              if (isLeaf(leaves[i])) continue;
+              const float A = halfArea(bounds[leaves[i]]);
+              if (A > bestArea) { bestArea = A; best = i; }
+            }
+            if (best == -1) return;
+
+            const unsigned int node = leaves[best];
+            inner[numInner++] = node;
+            leaves[best] = left[node];
+            leaves[numLeaves++] = right[node];
+          }
+
+          /* minimal cost of each subset of treelet leaves, proper subsets are numerically smaller than their set */
+          const unsigned int numSubsets = 1 << TREELET_LEAVES;
+          float copt[numSubsets];
+          unsigned char part[numSubsets];
+          for (unsigned int s=1; s<numSubsets; s++)
+          {
+            BBox3fa b(empty);
+            for (size_t i=0; i<TREELET_LEAVES; i++)
+              if (s & (1 << i)) b.extend(bounds[leaves[i]]);
+
+            if ((s & (s-1)) == 0) {
+              copt[s] = cost[leaves[bsf(s)]];
+              part[s] = 0;
+              continue;
+            }
+
+            /* each partition is visited once by keeping the lowest element on the left side */
+            const unsigned int lowest = s & (0-s);
+            float bestCost = inf;
+            unsigned int bestPart = 0;
+            for (unsigned int p=(s-1)&s; p; p=(p-1)&s)
+            {
+              if (!(p & lowest)) continue;
+              const float c = copt[p] + copt[s^p];
+              if (c < bestCost) { bestCost = c; bestPart = p; }
+            }
+            copt[s] = settings.travCost*halfArea(b) + bestCost;
+            part[s] = (unsigned char) bestPart;
+          }
+
+          if (copt[numSubsets-1] >= cost[root])
+            return;
+
+          size_t nextInner = 0;
+          rebuildTreelet(root,numSubsets-1,leaves,inner,nextInner,part);
+        }
+
+        void rebuildTreelet(unsigned int node, unsigned int s, const unsigned int* leaves, const unsigned int* inner, size_t& nextInner, const unsigned char* part)
+        {
+          const unsigned int sets[2] = { part[s], s ^ part[s] };
+          unsigned int children[2];
+          for (size_t c=0; c<2; c++)
+          {
+            if ((sets[c] & (sets[c]-1)) == 0)
+              children[c] = leaves[bsf(sets[c])];
+            else {
+              children[c] = inner[nextInner++];
+              rebuildTreelet(children[c],sets[c],leaves,inner,nextInner,part);
+            }
+            parent[children[c]] = node;
+          }
+          left[node] = children[0];
+          right[node] = children[1];
+          refit(node);
+        }
+
+      private:
+        const CreateLeafFunc& createLeaf;
+        const CreateNodeFunc& createNode;
+        const Settings settings;
+        size_t n;
+        avector<uint64_t> codes;
+        std::vector<unsigned int> left, right, parent;
+        avector<BBox3fa> bounds;
+        std::vector<float> cost;
+        std::vector<unsigned int> size;
+        std::vector<std::atomic<unsigned int>> counters;
+      };
+
+      /*! builds a binary BVH, createLeaf(prims,i) creates a leaf for the i'th sorted primitive, and
+       *  createNode(left,right,bounds) creates an inner node after both children got created */
+      template<typename ReductionTy, typename CreateLeafFunc, typename CreateNodeFunc>
+      static ReductionTy build(const CreateLeafFunc& createLeaf, const CreateNodeFunc& createNode,
+                               PrimRef* prims, const PrimInfo& pinfo, const Settings& settings)
+      {
+        BuilderT<ReductionTy,CreateLeafFunc,CreateNodeFunc> builder(createLeaf,createNode,settings);
+        return builder.build(prims,pinfo);
+      }
+    };
+  }
+}
@@ -0,0 +1,186 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh_builder_morton.h"
+#include "priminfo.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /* Parallel locally-ordered clustering builder (Meister and Bittner
+     * 2018). The primitives are sorted along a Morton curve and each
+     * primitive starts as a cluster. In each iteration every cluster
+     * searches its nearest neighbor within a small window of the sorted
+     * cluster list, mutual nearest neighbors get merged into a new
+     * cluster, and the cluster list gets compacted. This builds a binary
+     * BVH bottom up with SAH quality close to a top down SAH builder. */
+    struct BVHBuilderPLOC
+    {
+      /*! number of clusters searched on each side of a cluster */
+      static const size_t DEFAULT_SEARCH_RADIUS = 16;
+
+      /*! number of clusters processed by a task */
+      static const size_t BLOCK_SIZE = 1024;
+
+      typedef BVHBuilderMorton::BuildPrim BuildPrim;
+
+      template<typename ReductionTy, typename CreateLeafFunc, typename CreateNodeFunc>
+      class BuilderT
+      {
+      public:
+
+        BuilderT (const CreateLeafFunc& createLeaf, const CreateNodeFunc& createNode, size_t searchRadius)
+          : createLeaf(createLeaf), createNode(createNode), searchRadius(searchRadius) {}
+
+        /*! sorts the primitives along the Morton curve and builds the binary BVH over them */
+        ReductionTy build(PrimRef* prims, const PrimInfo& pinfo)
+        {
+          const size_t numPrimitives = pinfo.size();
+          if (numPrimitives == 1) return createLeaf(prims,0);
+
+          /* sort primitives by the Morton code of their centroid */
+          {
+            avector<BuildPrim> morton(numPrimitives), tmp(numPrimitives);
+            const BVHBuilderMorton::MortonCodeMapping mapping(pinfo.centBounds);
+            parallel_for(size_t(0), numPrimitives, BLOCK_SIZE, [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                  morton[i].code = mapping.code(prims[i].bounds());
+                  morton[i].index = (unsigned int) i;
+                }
+              });
+            radix_sort_u32(morton.data(),tmp.data(),numPrimitives);
+
+            avector<PrimRef> sorted(numPrimitives);
+            parallel_for(size_t(0), numPrimitives, BLOCK_SIZE, [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++)
+                  sorted[i] = prims[morton[i].index];
+              });
+            parallel_for(size_t(0), numPrimitives, BLOCK_SIZE, [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++)
+                  prims[i] = sorted[i];
+              });
+          }
+
+          /* every primitive starts as a cluster */
+          clusters[0].resize(numPrimitives); clusters[1].resize(numPrimitives);
+          bounds[0].resize(numPrimitives); bounds[1].resize(numPrimitives);
+          neighbors.resize(numPrimitives);
+          parallel_for(size_t(0), numPrimitives, BLOCK_SIZE, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                clusters[0][i] = createLeaf(prims,i);
+                bounds[0][i] = prims[i].bounds();
+              }
+            });
+
+          size_t num = numPrimitives;
+          size_t cur = 0;
+          std::vector<size_t> blockOffsets;
+          while (num > 1)
+          {
+            ReductionTy* C = clusters[cur].data();
+            BBox3fa* B = bounds[cur].data();
+
+            /* find nearest neighbor of each cluster within the search window */
+            parallel_for(size_t(0), num, BLOCK_SIZE, [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++)
+                  neighbors[i] = findNeighbor(B,i,num);
+              });
+
+            /* merge mutual nearest neighbors into the cluster of lower index */
+            const size_t numBlocks = (num+BLOCK_SIZE-1)/BLOCK_SIZE;
+            blockOffsets.resize(numBlocks+1);
+            parallel_for(size_t(0), numBlocks, [&] (const range<size_t>& r) {
+                for (size_t b=r.begin(); b<r.end(); b++)
+                {
+                  size_t count = 0;
+                  for (size_t i=b*BLOCK_SIZE; i<min(num,(b+1)*BLOCK_SIZE); i++)
+                  {
+                    const size_t j = neighbors[i];
+                    if (neighbors[j] != i) { count++; continue; }
+                    if (j < i) continue;
+                    B[i] = merge(B[i],B[j]);
+                    C[i] = createNode(C[i],C[j],B[i]);
+                    count++;
+                  }
+                  blockOffsets[b] = count;
+                }
+              });
+
+            /* compact the clusters into the other buffer */
+            size_t sum = 0;
+            for (size_t b=0; b<numBlocks; b++) {
+              const size_t count = blockOffsets[b];
+              blockOffsets[b] = sum;
+              sum += count;
+            }
+            ReductionTy* dstC = clusters[1-cur].data();
+            BBox3fa* dstB = bounds[1-cur].data();
+            parallel_for(size_t(0), numBlocks, [&] (const range<size_t>& r) {
+                for (size_t b=r.begin(); b<r.end(); b++)
+                {
+                  size_t k = blockOffsets[b];
+                  for (size_t i=b*BLOCK_SIZE; i<min(num,(b+1)*BLOCK_SIZE); i++)
+                  {
+                    const size_t j = neighbors[i];
+                    if (neighbors[j] == i && j < i) continue;
+                    dstC[k] = C[i];
+                    dstB[k] = B[i];
+                    k++;
+                  }
+                }
+              });
+
+            assert(sum < num);
+            num = sum;
+            cur = 1-cur;
+          }
+
+          return clusters[cur][0];
+        }
+
+      private:
+
+        /*! the neighbor of minimal merged surface area, ties get resolved by the index pair to avoid merge cycles */
+        __forceinline size_t findNeighbor(const BBox3fa* B, size_t i, size_t num) const
+        {
+          const size_t begin = i > searchRadius ? i-searchRadius : 0;
+          const size_t end = min(num,i+searchRadius+1);
+          float bestArea = inf;
+          size_t best = i == 0 ? 1 : i-1;
+          for (size_t j=begin; j<end; j++)
+          {
+            if (j == i) continue;
+            const float A = halfArea(merge(B[i],B[j]));
+            if (A < bestArea || (A == bestArea && min(i,j) < min(i,best)) || (A == bestArea && min(i,j) == min(i,best) && max(i,j) < max(i,best))) {
+              bestArea = A;
+              best = j;
+            }
+          }
+          return best;
+        }
+
+      private:
+        const CreateLeafFunc& createLeaf;
+        const CreateNodeFunc& createNode;
+        const size_t searchRadius;
+        avector<ReductionTy> clusters[2];
+        avector<BBox3fa> bounds[2];
+        std::vector<size_t> neighbors;
+      };
+
+      /*! builds a binary BVH, createLeaf(prims,i) creates a leaf for the i'th sorted primitive, and
+       *  createNode(left,right,bounds) creates an inner node for two clusters */
+      template<typename ReductionTy, typename CreateLeafFunc, typename CreateNodeFunc>
+      static ReductionTy build(const CreateLeafFunc& createLeaf, const CreateNodeFunc& createNode,
+                               PrimRef* prims, const PrimInfo& pinfo, size_t searchRadius = DEFAULT_SEARCH_RADIUS)
+      {
+        BuilderT<ReductionTy,CreateLeafFunc,CreateNodeFunc> builder(createLeaf,createNode,searchRadius);
+        return builder.build(prims,pinfo);
+      }
+    };
+  }
+}
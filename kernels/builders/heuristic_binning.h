@@ -65,6 +65,25 @@ namespace embree
           return Vec3ia(clamp(i,vint4(0),vint4(num-1)));
         }
 
+        /*! slower but safe binning of two points at once */
+        __forceinline void bin(const Vec3fa& p0, const Vec3fa& p1, vint4& bin0, vint4& bin1) const
+        {
+#if defined(__AVX__)
+          const vint8 i = floori((vfloat8(vfloat4(p0),vfloat4(p1))-vfloat8(ofs,ofs))*vfloat8(scale,scale));
+          assert(i[0] >= 0 && (size_t)i[0] < num && i[4] >= 0 && (size_t)i[4] < num);
+          assert(i[1] >= 0 && (size_t)i[1] < num && i[5] >= 0 && (size_t)i[5] < num);
+          assert(i[2] >= 0 && (size_t)i[2] < num && i[6] >= 0 && (size_t)i[6] < num);
+
+          // we clamp to handle corner cases that could calculate out of bounds bin
+          const vint8 c = clamp(i,vint8(0),vint8(int(num-1)));
+          bin0 = extract4<0>(c);
+          bin1 = extract4<1>(c);
+#else
+          bin0 = (vint4)bin(p0);
+          bin1 = (vint4)bin(p1);
+#endif
+        }
+
         /*! faster but unsafe binning */
         __forceinline Vec3ia bin_unsafe(const Vec3fa& p) const {
           return Vec3ia(floori((vfloat4(p)-ofs)*scale));
@@ -186,6 +205,11 @@ namespace embree
 	clear();
       }
 
+      /*! only clears the bins used by a mapping of numBins many bins */
+      __forceinline BinInfoT(EmptyTy, const size_t numBins) {
+	clear(numBins);
+      }
+
       /*! bin access function */
       __forceinline BBox &bounds(const size_t binID, const size_t dimID)             { return _bounds[binID][dimID]; }
       __forceinline const BBox &bounds(const size_t binID, const size_t dimID) const { return _bounds[binID][dimID]; }
@@ -197,9 +221,10 @@ namespace embree
       __forceinline const vuint4 &counts(const size_t binID) const { return _counts[binID]; }
 
       /*! clears the bin info */
-      __forceinline void clear() 
+      __forceinline void clear(const size_t numBins = BINS) 
       {
-	for (size_t i=0; i<BINS; i++) {
+	assert(numBins <= BINS);
+	for (size_t i=0; i<numBins; i++) {
 	  bounds(i,0) = bounds(i,1) = bounds(i,2) = empty;
 	  counts(i) = vuint4(zero);
 	}
@@ -215,11 +240,12 @@ namespace embree
           /*! map even and odd primitive to bin */
           BBox prim0; Vec3fa center0;
           prims[i+0].binBoundsAndCenter(prim0,center0); 
-          const vint4 bin0 = (vint4)mapping.bin(center0); 
           
           BBox prim1; Vec3fa center1;
           prims[i+1].binBoundsAndCenter(prim1,center1); 
-          const vint4 bin1 = (vint4)mapping.bin(center1); 
+
+          vint4 bin0, bin1;
+          mapping.bin(center0,center1,bin0,bin1);
           
           /*! increase bounds for bins for even primitive */
           const unsigned int b00 = extract<0>(bin0); bounds(b00,0).extend(prim0); 
@@ -266,9 +292,8 @@ namespace embree
         {
           /*! map even and odd primitive to bin */
           BBox prim0; Vec3fa center0; binBoundsAndCenter.binBoundsAndCenter(prims[i+0],prim0,center0); 
-          const vint4 bin0 = (vint4)mapping.bin(center0); 
           BBox prim1; Vec3fa center1; binBoundsAndCenter.binBoundsAndCenter(prims[i+1],prim1,center1); 
-          const vint4 bin1 = (vint4)mapping.bin(center1); 
+          vint4 bin0, bin1; mapping.bin(center0,center1,bin0,bin1);
           
           /*! increase bounds for bins for even primitive */
           const unsigned int s0 = prims[i+0].size();
@@ -508,7 +533,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty,mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
@@ -520,7 +545,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping,binBoundsAndCenter);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty,mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
@@ -532,7 +557,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty,mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
@@ -544,7 +569,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping,binBoundsAndCenter);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty,mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
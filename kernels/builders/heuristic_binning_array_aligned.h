@@ -104,8 +104,8 @@ namespace embree
         template<bool parallel>
         __forceinline const Split find_template(const PrimInfoRange& pinfo, const size_t logBlockSize)
         {
-          Binner binner(empty);
           const BinMapping<BINS> mapping(pinfo);
+          Binner binner(empty,mapping.size());
           bin_serial_or_parallel<parallel>(binner,prims,pinfo.begin(),pinfo.end(),PARALLEL_FIND_BLOCK_SIZE,mapping);
           return binner.best(mapping,logBlockSize);
         }
@@ -122,8 +122,8 @@ namespace embree
         template<bool parallel>
         __forceinline const Split find_block_size_template(const PrimInfoRange& pinfo, const size_t blockSize)
         {
-          Binner binner(empty);
           const BinMapping<BINS> mapping(pinfo);
+          Binner binner(empty,mapping.size());
           bin_serial_or_parallel<parallel>(binner,prims,pinfo.begin(),pinfo.end(),PARALLEL_FIND_BLOCK_SIZE,mapping);
           return binner.best_block_size(mapping,blockSize);
         }
@@ -216,8 +216,8 @@ namespace embree
         /*! finds the best split */
         const Split find(const SetMB& set, const size_t logBlockSize)
         {
-          ObjectBinner binner(empty);
           const BinMapping<BINS> mapping(set.size(),set.centBounds);
+          ObjectBinner binner(empty,mapping.size());
           bin_parallel(binner,set.prims->data(),set.begin(),set.end(),PARALLEL_FIND_BLOCK_SIZE,PARALLEL_THRESHOLD,mapping);
           Split osplit = binner.best(mapping,logBlockSize);
           osplit.sah *= set.time_range.size();
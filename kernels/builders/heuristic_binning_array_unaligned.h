@@ -103,8 +103,8 @@ namespace embree
         template<bool parallel>
         const Split find_template(const PrimInfoRange& set, const size_t logBlockSize, const LinearSpace3fa& space)
         {
-          Binner binner(empty);
           const BinMapping<BINS> mapping(set);
+          Binner binner(empty,mapping.size());
           BinBoundsAndCenter binBoundsAndCenter(scene,space);
           bin_serial_or_parallel<parallel>(binner,prims,set.begin(),set.end(),size_t(4096),mapping,binBoundsAndCenter);
           return binner.best(mapping,logBlockSize);
@@ -268,8 +268,8 @@ namespace embree
         const Split find(const SetMB& set, const size_t logBlockSize, const LinearSpace3fa& space)
         {
           BinBoundsAndCenter binBoundsAndCenter(scene,set.time_range,space);
-          ObjectBinner binner(empty);
           const BinMapping<BINS> mapping(set.size(),set.centBounds);
+          ObjectBinner binner(empty,mapping.size());
           bin_parallel(binner,set.prims->data(),set.begin(),set.end(),PARALLEL_FIND_BLOCK_SIZE,PARALLEL_THRESHOLD,mapping,binBoundsAndCenter);
           Split osplit = binner.best(mapping,logBlockSize);
           osplit.sah *= set.time_range.size();
@@ -6,12 +6,68 @@
 
 namespace embree
 {
+  /*! data of each allocator block is stored page aligned, such that files can get memory mapped */
+  static const size_t BVH_FILE_BLOCK_ALIGNMENT = 4096;
+
+  /*! maximal length of the primitive type name stored in the file */
+  static const size_t BVH_FILE_MAX_NAME_LENGTH = 32;
+
+  /*! allocator block as stored in a BVH file */
+  struct BVHFileBlock
+  {
+    uint64_t base;   //!< address of the block data when the BVH got stored
+    uint64_t bytes;  //!< number of used bytes of the block
+    uint64_t offset; //!< file offset of the block data
+  };
+
+  template<typename T>
+  static __forceinline void writeBVHFile(std::ostream& stream, const T& v) {
+    stream.write((const char*)&v,sizeof(T));
+  }
+
+  template<typename T>
+  static __forceinline void readBVHFile(std::istream& stream, T& v) {
+    stream.read((char*)&v,sizeof(T));
+  }
+
+  /*! finds the block some stored address points into */
+  static const BVHFileBlock* findBVHFileBlock(const std::vector<BVHFileBlock>& blocks, uint64_t ptr)
+  {
+    auto block = std::upper_bound(blocks.begin(),blocks.end(),ptr,[] (uint64_t p, const BVHFileBlock& b) { return p < b.base; });
+    if (block == blocks.begin()) return nullptr;
+    --block;
+    if (ptr >= block->base+block->bytes) return nullptr;
+    return &*block;
+  }
+
+  /*! calls the closure for each node reference of the BVH, the children of a node are visited after the closure modified the reference to the node */
+  template<int N, typename Closure>
+  static bool forEachNodeRef(NodeRefPtr<N>& root, const Closure& closure)
+  {
+    std::vector<NodeRefPtr<N>*> stack;
+    stack.push_back(&root);
+    while (!stack.empty())
+    {
+      NodeRefPtr<N>& ref = *stack.back(); stack.pop_back();
+      if (ref == NodeRefPtr<N>::emptyNode) continue;
+      if (!closure(ref)) return false;
+      if (ref.isLeaf()) continue;
+      BaseNode_t<NodeRefPtr<N>,N>* node = ref.baseNode();
+      for (size_t c=0; c<N; c++)
+        stack.push_back(&node->child(c));
+    }
+    return true;
+  }
+
   template<int N>
   BVHN<N>::BVHN (const PrimitiveType& primTy, Scene* scene)
     : AccelData((N==4) ? AccelData::TY_BVH4 : (N==8) ? AccelData::TY_BVH8 : AccelData::TY_UNKNOWN),
       primTy(&primTy), device(scene->device), scene(scene),
       root(emptyNode), alloc(scene->device,scene->isStaticAccel()), numPrimitives(0), numVertices(0)
   {
+    alloc.setMemoryBudget(&scene->memoryBudget);
+    if (scene->isDynamicAccel())
+      alloc.setBlockRetention(device->alloc_retain_blocks,device->alloc_double_buffer);
   }
 
   template<int N>
@@ -36,6 +92,117 @@ namespace embree
     this->numPrimitives = numPrimitives;
   }	
 
+  template<int N>
+  bool BVHN<N>::save(std::ostream& stream)
+  {
+    /* we can only store BVHs whose nodes and primitives do not reference memory outside the allocator */
+    const std::string name = primTy->name();
+    if (name == "instance" || name == "subdivpatch1" || name.size() >= BVH_FILE_MAX_NAME_LENGTH)
+      return false;
+    if (objects.size() || subdiv_patches.size())
+      return false;
+
+    std::vector<BVHFileBlock> blocks;
+    alloc.iterateUsedBlocks([&] (const char* ptr, size_t bytes) {
+        BVHFileBlock block; block.base = (uint64_t)(size_t)ptr; block.bytes = bytes; block.offset = 0;
+        blocks.push_back(block);
+      });
+    std::sort(blocks.begin(),blocks.end(),[] (const BVHFileBlock& a, const BVHFileBlock& b) { return a.base < b.base; });
+
+    NodeRef ref = root;
+    const bool valid = forEachNodeRef<N>(ref,[&] (NodeRef& ref) {
+        return findBVHFileBlock(blocks,size_t(ref) & ~size_t(NodeRef::align_mask)) != nullptr;
+      });
+    if (!valid) return false;
+
+    char primTyName[BVH_FILE_MAX_NAME_LENGTH];
+    memset(primTyName,0,sizeof(primTyName));
+    memcpy(primTyName,name.c_str(),name.size());
+
+    writeBVHFile(stream,uint32_t(N));
+    stream.write(primTyName,sizeof(primTyName));
+    writeBVHFile(stream,bounds);
+    writeBVHFile(stream,uint64_t(numPrimitives));
+    writeBVHFile(stream,uint64_t(numVertices));
+    writeBVHFile(stream,uint64_t(size_t(root)));
+    writeBVHFile(stream,uint64_t(blocks.size()));
+
+    size_t offset = size_t(stream.tellp()) + blocks.size()*sizeof(BVHFileBlock);
+    for (auto& block : blocks) {
+      block.offset = (offset+BVH_FILE_BLOCK_ALIGNMENT-1) & ~(BVH_FILE_BLOCK_ALIGNMENT-1);
+      offset = block.offset + block.bytes;
+    }
+    for (const auto& block : blocks)
+      writeBVHFile(stream,block);
+
+    const char zeros[BVH_FILE_BLOCK_ALIGNMENT] = { 0 };
+    for (const auto& block : blocks) {
+      stream.write(zeros,block.offset-size_t(stream.tellp()));
+      stream.write((const char*)(size_t)block.base,block.bytes);
+    }
+    return stream.good();
+  }
+
+  template<int N>
+  bool BVHN<N>::load(std::istream& stream)
+  {
+    uint32_t numChildren = 0;
+    char primTyName[BVH_FILE_MAX_NAME_LENGTH];
+    LBBox3fa lbounds;
+    uint64_t numPrims = 0, numVerts = 0, rootRef = 0, numBlocks = 0;
+    readBVHFile(stream,numChildren);
+    stream.read(primTyName,sizeof(primTyName));
+    readBVHFile(stream,lbounds);
+    readBVHFile(stream,numPrims);
+    readBVHFile(stream,numVerts);
+    readBVHFile(stream,rootRef);
+    readBVHFile(stream,numBlocks);
+    if (!stream || numChildren != N) return false;
+    primTyName[BVH_FILE_MAX_NAME_LENGTH-1] = 0;
+    if (strcmp(primTyName,primTy->name()) != 0) return false;
+
+    std::vector<BVHFileBlock> blocks(numBlocks);
+    for (auto& block : blocks)
+      readBVHFile(stream,block);
+    if (!stream) return false;
+    size_t end = size_t(stream.tellg());
+
+    /* copy each stored block into a block of the allocator */
+    clear();
+    std::vector<char*> ptrs(blocks.size());
+    for (size_t i=0; i<blocks.size(); i++)
+    {
+      ptrs[i] = (char*) alloc.mallocBlock(blocks[i].bytes);
+      stream.seekg(blocks[i].offset);
+      stream.read(ptrs[i],blocks[i].bytes);
+      end = max(end,size_t(blocks[i].offset+blocks[i].bytes));
+    }
+    if (!stream) {
+      clear();
+      return false;
+    }
+    stream.seekg(end);
+
+    /* fix up all node references to point into the new blocks */
+    NodeRef newRoot = NodeRef(size_t(rootRef));
+    const bool valid = forEachNodeRef<N>(newRoot,[&] (NodeRef& ref) {
+        const uint64_t ptr = size_t(ref) & ~size_t(NodeRef::align_mask);
+        const BVHFileBlock* block = findBVHFileBlock(blocks,ptr);
+        if (block == nullptr) return false;
+        ref = NodeRef(size_t(ptrs[block-blocks.data()] + (ptr-block->base)) | (size_t(ref) & size_t(NodeRef::align_mask)));
+        return true;
+      });
+    if (!valid) {
+      clear();
+      return false;
+    }
+
+    alloc.cleanup();
+    set(newRoot,lbounds,numPrims);
+    numVertices = numVerts;
+    return true;
+  }
+
   template<int N>
   void BVHN<N>::clearBarrier(NodeRef& node)
   {
@@ -126,6 +293,34 @@ namespace embree
     return t0;
   }
 
+  template<int N>
+  void BVHN<N>::getMemoryStatistics(RTCSceneMemoryStatistics& stat)
+  {
+    const FastAllocator::Statistics allocStat = alloc.getStatistics(FastAllocator::ANY_TYPE);
+
+    /* the top-level BVH of a two-level BVH references the nodes of the object BVHs, thus only its own blocks get counted */
+    bool twoLevel = false;
+    for (size_t i=0; i<objects.size(); i++)
+      twoLevel |= objects[i] != nullptr;
+
+    if (twoLevel)
+    {
+      stat.nodeBytes += allocStat.bytesUsed;
+      stat.freeBytes += allocStat.bytesFree;
+      stat.wastedBytes += allocStat.bytesWasted;
+      for (size_t i=0; i<objects.size(); i++)
+        if (objects[i]) objects[i]->getMemoryStatistics(stat);
+      return;
+    }
+
+    const BVHNStatistics<N> bvhStat(this);
+    const size_t bytesStored = bvhStat.bytesNodes()+bvhStat.bytesLeaves();
+    stat.nodeBytes += bvhStat.bytesNodes();
+    stat.leafBytes += bvhStat.bytesLeaves();
+    stat.freeBytes += allocStat.bytesFree;
+    stat.wastedBytes += allocStat.bytesWasted + (allocStat.bytesUsed > bytesStored ? allocStat.bytesUsed-bytesStored : 0); // padding inside used blocks
+  }
+
   template<int N>
   void BVHN<N>::postBuild(double t0)
   {
@@ -99,6 +99,15 @@ namespace embree
     
     /*! sets BVH members after build */
     void set (NodeRef root, const LBBox3fa& bounds, size_t numPrimitives);
+
+    /*! stores the BVH into a stream */
+    bool save(std::ostream& stream);
+
+    /*! restores the BVH from a stream */
+    bool load(std::istream& stream);
+
+    /*! adds node, leaf, and allocator statistics of this BVH and all object BVHs */
+    void getMemoryStatistics(RTCSceneMemoryStatistics& stat);
     
     /*! Clears the barrier bits of a subtree. */
     void clearBarrier(NodeRef& node);
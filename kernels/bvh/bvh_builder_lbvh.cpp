@@ -0,0 +1,149 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh.h"
+#include "bvh_builder.h"
+#include "bvh_collapse.h"
+#include "bvh_reorder.h"
+#include "../builders/bvh_builder_lbvh.h"
+#include "../builders/primrefgen.h"
+
+#include "../geometry/triangle.h"
+#include "../geometry/trianglev.h"
+#include "../geometry/trianglei.h"
+
+#include "../common/state.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    template<int N, typename Primitive>
+    struct CreateLeafLBVH
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+
+      __forceinline CreateLeafLBVH (BVH* bvh) : bvh(bvh) {}
+
+      __forceinline NodeRef operator() (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const
+      {
+        size_t n = set.size();
+        size_t items = Primitive::blocks(n);
+        size_t start = set.begin();
+        Primitive* accel = (Primitive*) alloc.malloc1(items*sizeof(Primitive),BVH::byteAlignment);
+        typename BVH::NodeRef node = BVH::encodeLeaf((char*)accel,items);
+        for (size_t i=0; i<items; i++) {
+          accel[i].fill(prims,start,set.end(),bvh->scene);
+        }
+        return node;
+      }
+
+      BVH* bvh;
+    };
+
+    /* Builds a binary linear BVH over 63 bit Morton codes, optionally
+     * optimizes its treelets, and collapses it to the BVH width with
+     * minimal SAH cost. */
+    template<int N, typename Mesh, typename Primitive>
+    struct BVHNBuilderLBVH : public Builder
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+
+      BVH* bvh;
+      Scene* scene;
+      mvector<PrimRef> prims;
+      GeneralBVHBuilder::Settings settings;
+      const bool treelets;
+
+      BVHNBuilderLBVH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
+        : bvh(bvh), scene(scene), prims(scene->device,0),
+          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
+          treelets(mode & MODE_HIGH_QUALITY) {}
+
+      void build()
+      {
+        /* skip build for empty scene */
+        const size_t numPrimitives = scene->getNumPrimitives(Mesh::geom_type,false);
+        if (numPrimitives == 0) {
+          bvh->clear();
+          prims.clear();
+          return;
+        }
+
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderLBVH");
+
+        /* initialize allocator */
+        const size_t node_bytes = numPrimitives*sizeof(typename BVH::AABBNode)/(4*N);
+        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numPrimitives)*sizeof(Primitive));
+        bvh->alloc.init_estimate(node_bytes+leaf_bytes);
+        settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
+        prims.resize(numPrimitives);
+
+        const PrimInfo pinfo = createPrimRefArray(scene,Mesh::geom_type,false,numPrimitives,prims,bvh->scene->progressInterface);
+
+        /* pinfo might has zero size due to invalid geometry */
+        if (unlikely(pinfo.size() == 0))
+        {
+          bvh->clear();
+          prims.clear();
+          return;
+        }
+
+        /* build a binary BVH over the sorted primitives and collapse it */
+        BVHNCollapse<N> collapser(bvh,pinfo.size(),settings);
+
+        auto createLeaf = [&] (const PrimRef* prims, size_t i) -> unsigned int {
+          const unsigned int ref = collapser.allocNode();
+          collapser.setLeafNode(ref,prims[i].bounds(),range<size_t>(i,i+1));
+          return ref;
+        };
+
+        auto createNode = [&] (unsigned int left, unsigned int right, const BBox3fa& bounds) -> unsigned int {
+          const unsigned int ref = collapser.allocNode();
+          collapser.setInnerNode(ref,bounds,left,right);
+          return ref;
+        };
+
+        const BVHBuilderLBVH::Settings lbvhSettings(settings.travCost/float(bsr(N)),settings.intCost,
+                                                    treelets ? BVHBuilderLBVH::DEFAULT_TREELET_ITERATIONS : 0);
+        const unsigned int broot = BVHBuilderLBVH::build<unsigned int>(createLeaf,createNode,prims.data(),pinfo,lbvhSettings);
+        bvh->scene->progressInterface(pinfo.size());
+        NodeRef root = collapser.collapse(broot,prims.data(),CreateLeafLBVH<N,Primitive>(bvh));
+
+        bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+        bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+
+        /* clear temporary data for static geometry */
+        if (scene->isStaticAccel()) {
+          prims.clear();
+        }
+        bvh->cleanup();
+        BVHNReorder<N>::reorderStatic(bvh);
+        bvh->postBuild(t0);
+      }
+
+      void clear() {
+        prims.clear();
+      }
+    };
+
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+
+#if defined(EMBREE_GEOMETRY_TRIANGLE)
+    Builder* BVH4Triangle4SceneBuilderLBVH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderLBVH<4,TriangleMesh,Triangle4>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
+    Builder* BVH4Triangle4vSceneBuilderLBVH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderLBVH<4,TriangleMesh,Triangle4v>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
+    Builder* BVH4Triangle4iSceneBuilderLBVH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderLBVH<4,TriangleMesh,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
+
+#if defined(__AVX__)
+    Builder* BVH8Triangle4SceneBuilderLBVH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderLBVH<8,TriangleMesh,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
+    Builder* BVH8Triangle4vSceneBuilderLBVH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderLBVH<8,TriangleMesh,Triangle4v>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
+    Builder* BVH8Triangle4iSceneBuilderLBVH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderLBVH<8,TriangleMesh,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
+#endif
+#endif
+  }
+}
@@ -0,0 +1,144 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh.h"
+#include "bvh_builder.h"
+#include "bvh_collapse.h"
+#include "bvh_reorder.h"
+#include "../builders/bvh_builder_ploc.h"
+#include "../builders/primrefgen.h"
+
+#include "../geometry/triangle.h"
+#include "../geometry/trianglev.h"
+#include "../geometry/trianglei.h"
+
+#include "../common/state.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    template<int N, typename Primitive>
+    struct CreateLeafPLOC
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+
+      __forceinline CreateLeafPLOC (BVH* bvh) : bvh(bvh) {}
+
+      __forceinline NodeRef operator() (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const
+      {
+        size_t n = set.size();
+        size_t items = Primitive::blocks(n);
+        size_t start = set.begin();
+        Primitive* accel = (Primitive*) alloc.malloc1(items*sizeof(Primitive),BVH::byteAlignment);
+        typename BVH::NodeRef node = BVH::encodeLeaf((char*)accel,items);
+        for (size_t i=0; i<items; i++) {
+          accel[i].fill(prims,start,set.end(),bvh->scene);
+        }
+        return node;
+      }
+
+      BVH* bvh;
+    };
+
+    /* Builds a binary BVH by parallel locally-ordered clustering and
+     * collapses it to the BVH width with minimal SAH cost. */
+    template<int N, typename Mesh, typename Primitive>
+    struct BVHNBuilderPLOC : public Builder
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+
+      BVH* bvh;
+      Scene* scene;
+      mvector<PrimRef> prims;
+      GeneralBVHBuilder::Settings settings;
+
+      BVHNBuilderPLOC (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize)
+        : bvh(bvh), scene(scene), prims(scene->device,0),
+          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD) {}
+
+      void build()
+      {
+        /* skip build for empty scene */
+        const size_t numPrimitives = scene->getNumPrimitives(Mesh::geom_type,false);
+        if (numPrimitives == 0) {
+          bvh->clear();
+          prims.clear();
+          return;
+        }
+
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderPLOC");
+
+        /* initialize allocator */
+        const size_t node_bytes = numPrimitives*sizeof(typename BVH::AABBNode)/(4*N);
+        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numPrimitives)*sizeof(Primitive));
+        bvh->alloc.init_estimate(node_bytes+leaf_bytes);
+        settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
+        prims.resize(numPrimitives);
+
+        const PrimInfo pinfo = createPrimRefArray(scene,Mesh::geom_type,false,numPrimitives,prims,bvh->scene->progressInterface);
+
+        /* pinfo might has zero size due to invalid geometry */
+        if (unlikely(pinfo.size() == 0))
+        {
+          bvh->clear();
+          prims.clear();
+          return;
+        }
+
+        /* cluster the primitives into a binary BVH and collapse it */
+        BVHNCollapse<N> collapser(bvh,pinfo.size(),settings);
+
+        auto createLeaf = [&] (const PrimRef* prims, size_t i) -> unsigned int {
+          const unsigned int ref = collapser.allocNode();
+          collapser.setLeafNode(ref,prims[i].bounds(),range<size_t>(i,i+1));
+          return ref;
+        };
+
+        auto createNode = [&] (unsigned int left, unsigned int right, const BBox3fa& bounds) -> unsigned int {
+          const unsigned int ref = collapser.allocNode();
+          collapser.setInnerNode(ref,bounds,left,right);
+          return ref;
+        };
+
+        const unsigned int broot = BVHBuilderPLOC::build<unsigned int>(createLeaf,createNode,prims.data(),pinfo);
+        bvh->scene->progressInterface(pinfo.size());
+        NodeRef root = collapser.collapse(broot,prims.data(),CreateLeafPLOC<N,Primitive>(bvh));
+
+        bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+        bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+
+        /* clear temporary data for static geometry */
+        if (scene->isStaticAccel()) {
+          prims.clear();
+        }
+        bvh->cleanup();
+        BVHNReorder<N>::reorderStatic(bvh);
+        bvh->postBuild(t0);
+      }
+
+      void clear() {
+        prims.clear();
+      }
+    };
+
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+
+#if defined(EMBREE_GEOMETRY_TRIANGLE)
+    Builder* BVH4Triangle4SceneBuilderPLOC  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderPLOC<4,TriangleMesh,Triangle4>((BVH4*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH4Triangle4vSceneBuilderPLOC (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderPLOC<4,TriangleMesh,Triangle4v>((BVH4*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH4Triangle4iSceneBuilderPLOC (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderPLOC<4,TriangleMesh,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf); }
+
+#if defined(__AVX__)
+    Builder* BVH8Triangle4SceneBuilderPLOC  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderPLOC<8,TriangleMesh,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH8Triangle4vSceneBuilderPLOC (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderPLOC<8,TriangleMesh,Triangle4v>((BVH8*)bvh,scene,4,1.0f,4,inf); }
+    Builder* BVH8Triangle4iSceneBuilderPLOC (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderPLOC<8,TriangleMesh,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf); }
+#endif
+#endif
+  }
+}
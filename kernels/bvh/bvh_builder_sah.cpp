@@ -3,6 +3,7 @@
 
 #include "bvh.h"
 #include "bvh_builder.h"
+#include "bvh_reorder.h"
 #include "../builders/primrefgen.h"
 #include "../builders/splitter.h"
 
@@ -15,6 +16,7 @@
 #include "../geometry/quadi.h"
 #include "../geometry/object.h"
 #include "../geometry/instance.h"
+#include "../geometry/instance_array.h"
 #include "../geometry/subgrid.h"
 
 #include "../common/state.h"
@@ -182,6 +184,7 @@ namespace embree
           prims.clear();
         }
 	bvh->cleanup();
+        BVHNReorder<N>::reorderStatic(bvh);
         bvh->postBuild(t0);
       }
 
@@ -434,6 +437,7 @@ namespace embree
           prims.clear();
         }
 	bvh->cleanup();
+        BVHNReorder<N>::reorderStatic(bvh);
         bvh->postBuild(t0);
       }
 
@@ -530,6 +534,13 @@ namespace embree
 #endif
 #endif
 
+#if defined(EMBREE_GEOMETRY_INSTANCE_ARRAY)
+    Builder* BVH4InstanceArraySceneBuilderSAH (void* bvh, Scene* scene, Geometry::GTypeMask gtype) { return new BVHNBuilderSAH<4,InstanceArrayPrimitive>((BVH4*)bvh,scene,4,1.0f,1,1,gtype); }
+#if defined(__AVX__)
+    Builder* BVH8InstanceArraySceneBuilderSAH (void* bvh, Scene* scene, Geometry::GTypeMask gtype) { return new BVHNBuilderSAH<8,InstanceArrayPrimitive>((BVH8*)bvh,scene,8,1.0f,1,1,gtype); }
+#endif
+#endif
+
 #if defined(EMBREE_GEOMETRY_GRID)
     Builder* BVH4GridMeshBuilderSAH  (void* bvh, GridMesh* mesh, unsigned int geomID, size_t mode) { return new BVHNBuilderSAHGrid<4>((BVH4*)bvh,mesh,geomID,4,1.0f,4,4,mode); }
     Builder* BVH4GridSceneBuilderSAH (void* bvh, Scene* scene, size_t mode)   { return new BVHNBuilderSAHGrid<4>((BVH4*)bvh,scene,4,1.0f,4,4,mode); } // FIXME: check whether cost factors are correct
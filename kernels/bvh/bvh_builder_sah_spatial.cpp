@@ -3,6 +3,8 @@
 
 #include "bvh.h"
 #include "bvh_builder.h"
+#include "bvh_reorder.h"
+#include "bvh_collapse.h"
 
 #include "../builders/primrefgen.h"
 #include "../builders/primrefgen_presplit.h"
@@ -60,16 +62,17 @@ namespace embree
       mvector<PrimRef> prims0;
       GeneralBVHBuilder::Settings settings;
       const float splitFactor;
+      const bool collapse;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
       unsigned int numPreviousPrimitives = 0;
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(scene), mesh(nullptr), prims0(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications) {}
+          splitFactor(scene->device->max_spatial_split_replications), collapse(mode & MODE_COLLAPSE) {}
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Mesh* mesh, const unsigned int geomID, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(nullptr), mesh(mesh), prims0(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications), geomID_(geomID) {}
+          splitFactor(scene->device->max_spatial_split_replications), collapse(mode & MODE_COLLAPSE), geomID_(geomID) {}
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
@@ -121,7 +124,16 @@ namespace embree
 	    settings.maxDepth = BVH::maxBuildDepthLeaf;
 
 	    /* call BVH builder */
-	    root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeafSpatial<N,Primitive>(bvh),bvh->scene->progressInterface,prims0.data(),pinfo,settings);
+            if (collapse)
+            {
+              BVHNCollapse<N> collapser(bvh,pinfo.size(),settings);
+              const unsigned int broot = BVHBuilderBinnedSAH::build<unsigned int>(
+                collapser.createAlloc(),collapser.createNode(),collapser.updateNode(),collapser.createLeaf(),
+                bvh->scene->progressInterface,prims0.data(),pinfo,collapser.binarySettings());
+              root = collapser.collapse(broot,prims0.data(),CreateLeafSpatial<N,Primitive>(bvh));
+            }
+            else
+              root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeafSpatial<N,Primitive>(bvh),bvh->scene->progressInterface,prims0.data(),pinfo,settings);
 	  }
 	else
 	  {
@@ -141,16 +153,27 @@ namespace embree
 	    settings.maxDepth = BVH::maxBuildDepthLeaf;
 
 	    /* call BVH builder */
-	    root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
-								  typename BVH::CreateAlloc(bvh),
-								  typename BVH::AABBNode::Create2(),
-								  typename BVH::AABBNode::Set2(),
-								  CreateLeafSpatial<N,Primitive>(bvh),
-								  splitter,
-								  bvh->scene->progressInterface,
-								  prims0.data(),
-								  numSplitPrimitives,
-								  pinfo,settings);
+            if (collapse)
+            {
+              BVHNCollapse<N> collapser(bvh,numSplitPrimitives,settings);
+              const unsigned int broot = BVHBuilderBinnedFastSpatialSAH::build<unsigned int>(
+                collapser.createAlloc(),collapser.createNode(),collapser.updateNode(),collapser.createLeaf(),
+                splitter,bvh->scene->progressInterface,prims0.data(),numSplitPrimitives,pinfo,collapser.binarySettings());
+              root = collapser.collapse(broot,prims0.data(),CreateLeafSpatial<N,Primitive>(bvh));
+            }
+            else
+            {
+              root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
+                typename BVH::CreateAlloc(bvh),
+                typename BVH::AABBNode::Create2(),
+                typename BVH::AABBNode::Set2(),
+                CreateLeafSpatial<N,Primitive>(bvh),
+                splitter,
+                bvh->scene->progressInterface,
+                prims0.data(),
+                numSplitPrimitives,
+                pinfo,settings);
+            }
 
 	    /* ==================== */
 	  }
@@ -163,6 +186,7 @@ namespace embree
           prims0.clear();
         }
 	bvh->cleanup();
+        BVHNReorder<N>::reorderStatic(bvh);
         bvh->postBuild(t0);
       }
 
@@ -11,6 +11,7 @@
 #include "../common/scene_line_segments.h"
 #include "../common/scene_triangle_mesh.h"
 #include "../common/scene_quad_mesh.h"
+#include "../../common/algorithms/parallel_sort.h"
 
 #define PROFILE 0
 
@@ -20,7 +21,8 @@ namespace embree
   {
     template<int N, typename Mesh, typename Primitive>
     BVHNBuilderTwoLevel<N,Mesh,Primitive>::BVHNBuilderTwoLevel (BVH* bvh, Scene* scene, Geometry::GTypeMask gtype, bool useMortonBuilder, const size_t singleThreadThreshold)
-      : bvh(bvh), scene(scene), refs(scene->device,0), prims(scene->device,0), singleThreadThreshold(singleThreadThreshold), gtype(gtype), useMortonBuilder_(useMortonBuilder) {}
+      : bvh(bvh), scene(scene), refs(scene->device,0), prims(scene->device,0),
+        leaves(scene->device,0), nodes(scene->device,0), leafIDs(scene->device,0), leafOffsets(scene->device,0), singleThreadThreshold(singleThreadThreshold), gtype(gtype), useMortonBuilder_(useMortonBuilder) {}
     
     template<int N, typename Mesh, typename Primitive>
     BVHNBuilderTwoLevel<N,Mesh,Primitive>::~BVHNBuilderTwoLevel () {
@@ -43,6 +45,10 @@ namespace embree
             }
           });
       }
+
+      /* only refit the top-level hierarchy if few geometries got modified */
+      if (refitTopLevel())
+        return;
       
 #if PROFILE
       while(1) 
@@ -50,6 +56,7 @@ namespace embree
       {
       /* reset memory allocator */
       bvh->alloc.reset();
+      topLevelValid = false;
       
       /* skip build for empty scene */
       const size_t numPrimitives = scene->getNumPrimitives(gtype,false);
@@ -114,6 +121,11 @@ namespace embree
       /* fast path for single geometry scenes */
       if (nextRef == 1) { 
         bvh->set(refs[0].node,LBBox3fa(refs[0].bounds()),numPrimitives);
+#if ENABLE_DIRECT_SAH_MERGE_BUILDER
+        leaves.resize(1);
+        leaves[0] = TopLevelLeaf(refs[0].node,refs[0].geomID());
+        recordTopLevel(refs[0].node,refs[0].bounds());
+#endif
       }
 
       else
@@ -178,6 +190,8 @@ namespace embree
 #if ENABLE_DIRECT_SAH_MERGE_BUILDER
             
             refs.resize(extSize); 
+            leaves.resize(extSize);
+            nextLeaf.store(0);
          
             NodeRef root = BVHBuilderBinnedOpenMergeSAH::build<NodeRef,BuildRef>(
               typename BVH::CreateAlloc(bvh),
@@ -186,7 +200,9 @@ namespace embree
               
               [&] (const BuildRef* refs, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef  {
                 assert(range.size() == 1);
-                return (NodeRef) refs[range.begin()].node;
+                const BuildRef& ref = refs[range.begin()];
+                leaves[nextLeaf++] = TopLevelLeaf(ref.node,ref.geomID());
+                return (NodeRef) ref.node;
               },
               [&] (BuildRef &bref, BuildRef *refs) -> size_t { 
                 return openBuildRef(bref,refs);
@@ -209,6 +225,11 @@ namespace embree
 
             
             bvh->set(root,LBBox3fa(pinfo.geomBounds),numPrimitives);
+
+#if ENABLE_DIRECT_SAH_MERGE_BUILDER
+            leaves.resize(nextLeaf);
+            recordTopLevel(root,pinfo.geomBounds);
+#endif
           }
         }
       }  
@@ -226,6 +247,7 @@ namespace embree
     template<int N, typename Mesh, typename Primitive>
     void BVHNBuilderTwoLevel<N,Mesh,Primitive>::deleteGeometry(size_t geomID)
     {
+      topLevelValid = false;
       if (geomID >= bvh->objects.size()) return;
       if (builders[geomID]) builders[geomID].reset();
       delete bvh->objects [geomID]; bvh->objects [geomID] = nullptr;
@@ -241,6 +263,148 @@ namespace embree
         if (builders[i]) builders[i].reset();
 
       refs.clear();
+      topLevelValid = false;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNBuilderTwoLevel<N,Mesh,Primitive>::refitTopLevel()
+    {
+      const size_t num = scene->size();
+      if (!topLevelValid || num+1 != leafOffsets.size())
+        return false;
+
+      /* the recorded hierarchy stays invalid until the refit succeeded */
+      topLevelValid = false;
+
+      double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderTwoLevelRefit");
+
+      /* update the leaves of all modified geometries */
+      const bool valid = parallel_reduce(size_t(0), num, true, [&] (const range<size_t>& r) -> bool
+      {
+        for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+        {
+          if (!isGeometryModified(objectID))
+            continue;
+
+          /* geometries we ignore must not have leaves */
+          Mesh* mesh = scene->getSafe<Mesh>(objectID);
+          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1) {
+            if (topLevelLeavesBegin(objectID) != topLevelLeavesEnd(objectID)) return false;
+            continue;
+          }
+
+          /* a new build reference builder also requires new leaves */
+          const bool newBuilder = isSmallGeometry(mesh) ? setupSmallBuildRefBuilder(objectID,mesh) : setupLargeBuildRefBuilder(objectID,mesh);
+          if (newBuilder || !builders[objectID]->refitBuildRefs(this))
+            return false;
+        }
+        return true;
+      }, [] (const bool a, const bool b) { return a && b; });
+
+      if (!valid)
+        return false;
+
+      /* propagate the new leaf bounds to the parent nodes */
+      BBox3fa rootBounds = bvh->getBounds();
+      for (size_t i=0; i<leaves.size(); i++)
+      {
+        TopLevelLeaf& leaf = leaves[i];
+        if (!leaf.modified) continue;
+        leaf.modified = false;
+
+        if (leaf.parent == (unsigned int)-1)
+          rootBounds = leaf.bounds;
+        else {
+          nodes[leaf.parent].node.getAABBNode()->setBounds(leaf.slot,leaf.bounds);
+          nodes[leaf.parent].modified = true;
+        }
+      }
+
+      /* parents are stored before their children, thus a backwards pass refits bottom-up */
+      for (size_t i=nodes.size(); i>0; i--)
+      {
+        TopLevelNode& node = nodes[i-1];
+        if (!node.modified) continue;
+        node.modified = false;
+
+        const BBox3fa bounds = node.node.getAABBNode()->bounds();
+        const float area = halfArea(bounds);
+        topLevelArea += double(area) - double(node.area);
+        node.area = area;
+
+        if (node.parent == (unsigned int)-1)
+          rootBounds = bounds;
+        else {
+          nodes[node.parent].node.getAABBNode()->setBounds(node.slot,bounds);
+          nodes[node.parent].modified = true;
+        }
+      }
+
+      /* rebuild if the quality of the hierarchy degraded too much */
+      if (topLevelArea > double(TOPLEVEL_REFIT_MAX_SAH_FACTOR*topLevelSAH*halfArea(rootBounds)))
+        return false;
+
+      bvh->set(bvh->root,LBBox3fa(rootBounds),scene->getNumPrimitives(gtype,false));
+      bvh->postBuild(t0);
+      topLevelValid = true;
+      return true;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::recordTopLevel(NodeRef root, const BBox3fa& bounds)
+    {
+      /* sort leaves by node to find them during the traversal */
+      {
+        mvector<TopLevelLeaf> temp(scene->device,leaves.size());
+        radix_sort_u64(leaves.data(),temp.data(),leaves.size());
+      }
+
+      nodes.resize(0);
+      recordTopLevelNode(root,-1,0);
+
+      /* group the leaves by geometry */
+      const size_t num = scene->size();
+      leafOffsets.resize(num+1);
+      for (size_t i=0; i<=num; i++) leafOffsets[i] = 0;
+      for (size_t i=0; i<leaves.size(); i++) leafOffsets[leaves[i].geomID+1]++;
+      for (size_t i=0; i<num; i++) leafOffsets[i+1] += leafOffsets[i];
+
+      leafIDs.resize(leaves.size());
+      for (size_t i=0; i<leaves.size(); i++) {
+        leafIDs[leafOffsets[leaves[i].geomID]++] = (unsigned int) i;
+      }
+      for (size_t i=num; i>0; i--) leafOffsets[i] = leafOffsets[i-1];
+      leafOffsets[0] = 0;
+
+      /* calculate SAH cost relative to the root */
+      topLevelArea = 0.0;
+      for (size_t i=0; i<nodes.size(); i++) topLevelArea += double(nodes[i].area);
+      const float rootArea = halfArea(bounds);
+      topLevelSAH = rootArea > 0.0f ? float(topLevelArea/double(rootArea)) : 0.0f;
+      topLevelValid = rootArea > 0.0f || nodes.size() == 0;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::recordTopLevelNode(NodeRef ref, unsigned int parent, unsigned int slot)
+    {
+      /* stop at the leaves of the top-level hierarchy */
+      TopLevelLeaf* leaf = std::lower_bound(leaves.begin(),leaves.end(),(uint64_t)(size_t)ref,
+                                            [] (const TopLevelLeaf& a, uint64_t b) { return (uint64_t)a < b; });
+      if (leaf != leaves.end() && leaf->node == ref) {
+        leaf->parent = parent;
+        leaf->slot = slot;
+        return;
+      }
+
+      assert(ref.isAABBNode());
+      AABBNode* node = ref.getAABBNode();
+      const unsigned int index = (unsigned int) nodes.size();
+      nodes.push_back(TopLevelNode(ref,parent,slot,halfArea(node->bounds())));
+
+      for (unsigned int i=0; i<N; i++) {
+        if (node->child(i) == BVH::emptyNode) continue;
+        recordTopLevelNode(node->child(i),index,i);
+      }
     }
 
     template<int N, typename Mesh, typename Primitive>
@@ -284,19 +448,22 @@ namespace embree
     }
 
     template<int N, typename Mesh, typename Primitive>
-    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::setupSmallBuildRefBuilder (size_t objectID, Mesh const * const /*mesh*/)
+    bool BVHNBuilderTwoLevel<N,Mesh,Primitive>::setupSmallBuildRefBuilder (size_t objectID, Mesh const * const /*mesh*/)
     {
       if (builders[objectID] == nullptr ||                                         // new mesh
           dynamic_cast<RefBuilderSmall*>(builders[objectID].get()) == nullptr)     // size change resulted in large->small change
       {
         builders[objectID].reset (new RefBuilderSmall(objectID));
+        return true;
       }
+      return false;
     }
 
     template<int N, typename Mesh, typename Primitive>
-    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::setupLargeBuildRefBuilder (size_t objectID, Mesh const * const mesh)
+    bool BVHNBuilderTwoLevel<N,Mesh,Primitive>::setupLargeBuildRefBuilder (size_t objectID, Mesh const * const mesh)
     {
       if (bvh->objects[objectID] == nullptr ||                                  // new mesh
+          builders[objectID] == nullptr ||                                      // builders got cleared after a failed build
           builders[objectID]->meshQualityChanged (mesh->quality) ||             // changed build quality
           dynamic_cast<RefBuilderLarge*>(builders[objectID].get()) == nullptr)  // size change resulted in small->large change
       {
@@ -304,7 +471,9 @@ namespace embree
         delete bvh->objects[objectID]; 
         createMeshAccel(objectID, builder);
         builders[objectID].reset (new RefBuilderLarge(objectID, builder, mesh->quality));
+        return true;
       }
+      return false;
     }
 
 #if defined(EMBREE_GEOMETRY_TRIANGLE)
@@ -18,6 +18,9 @@
 #define SPLIT_MEMORY_RESERVE_SCALE 2
 #define SPLIT_MIN_EXT_SPACE 1000
 
+/* the refitted top-level hierarchy gets rebuilt once its SAH cost exceeds the cost after the last full build by this factor */
+#define TOPLEVEL_REFIT_MAX_SAH_FACTOR 1.5f
+
 namespace embree
 {
   namespace isa
@@ -101,6 +104,44 @@ namespace embree
         assert(n > 1);
         return n;        
       }
+
+      /*! leaf of the top-level hierarchy, which is either a primitive leaf of a small geometry or some node of an object BVH */
+      struct TopLevelLeaf
+      {
+        __forceinline TopLevelLeaf () {}
+
+        __forceinline TopLevelLeaf (NodeRef node, unsigned int geomID)
+          : node(node), geomID(geomID), parent(-1), slot(0), modified(false) {}
+
+        /* sort key for the radix sort */
+        __forceinline operator uint64_t() const {
+          return (uint64_t)(size_t)node;
+        }
+
+      public:
+        BBox3fa bounds;        //!< new bounds after an incremental update
+        NodeRef node;          //!< referenced node
+        unsigned int geomID;   //!< ID of the geometry the node belongs to
+        unsigned int parent;   //!< index of the parent top-level node, -1 for the root
+        unsigned int slot;     //!< child slot inside the parent node
+        bool modified;         //!< true if the bounds got updated
+      };
+
+      /*! inner node of the top-level hierarchy */
+      struct TopLevelNode
+      {
+        __forceinline TopLevelNode () {}
+
+        __forceinline TopLevelNode (NodeRef node, unsigned int parent, unsigned int slot, float area)
+          : node(node), parent(parent), slot(slot), area(area), modified(false) {}
+
+      public:
+        NodeRef node;          //!< top-level node
+        unsigned int parent;   //!< index of the parent top-level node, -1 for the root
+        unsigned int slot;     //!< child slot inside the parent node
+        float area;            //!< half area of the node bounds
+        bool modified;         //!< true if some child bounds got updated
+      };
       
       /*! Constructor. */
       BVHNBuilderTwoLevel (BVH* bvh, Scene* scene, Geometry::GTypeMask gtype = Mesh::geom_type, bool useMortonBuilder = false, const size_t singleThreadThreshold = DEFAULT_SINGLE_THREAD_THRESHOLD);
@@ -122,6 +163,7 @@ namespace embree
         virtual ~RefBuilderBase () {}
         virtual void attachBuildRefs (BVHNBuilderTwoLevel* builder) = 0;
         virtual bool meshQualityChanged (RTCBuildQuality currQuality) = 0;
+        virtual bool refitBuildRefs (BVHNBuilderTwoLevel* builder) = 0;
       };
 
       class RefBuilderSmall : public RefBuilderBase {
@@ -159,6 +201,33 @@ namespace embree
         bool meshQualityChanged (RTCBuildQuality /*currQuality*/) {
           return false;
         }
+
+        bool refitBuildRefs (BVHNBuilderTwoLevel* topBuilder)
+        {
+          Mesh* mesh = topBuilder->getMesh(objectID_);
+          size_t meshSize = mesh->size();
+          assert(isSmallGeometry(mesh));
+
+          mvector<PrimRef> prefs(topBuilder->scene->device, meshSize);
+          auto pinfo = createPrimRefArray(mesh,objectID_,meshSize,prefs,topBuilder->bvh->scene->progressInterface);
+
+          /* refill the leaves in place, which only works if their number did not change */
+          const unsigned int* leafID = topBuilder->topLevelLeavesBegin(objectID_);
+          const unsigned int* leafEnd = topBuilder->topLevelLeavesEnd(objectID_);
+          size_t begin=0;
+          while (begin < pinfo.size())
+          {
+            if (leafID == leafEnd) return false;
+            TopLevelLeaf& leaf = topBuilder->leaves[*leafID++];
+            size_t num; Primitive* accel = (Primitive*) leaf.node.leaf(num);
+            const size_t start = begin;
+            accel->fill(prefs.data(),begin,pinfo.size(),topBuilder->bvh->scene);
+            leaf.bounds = empty;
+            for (size_t i=start; i<begin; i++) leaf.bounds.extend(prefs[i].bounds());
+            leaf.modified = true;
+          }
+          return leafID == leafEnd;
+        }
         
         size_t  objectID_;
       };
@@ -176,6 +245,7 @@ namespace embree
           /* build object if it got modified */
           if (topBuilder->isGeometryModified(objectID_))
             builder_->build();
+          topologyVersion_ = topBuilder->getMesh(objectID_)->getTopologyVersion();
 
           /* create build primitive */
           if (!object->getBounds().empty())
@@ -193,14 +263,74 @@ namespace embree
           return currQuality != quality_;
         }
 
+        bool refitBuildRefs (BVHNBuilderTwoLevel* topBuilder)
+        {
+          BVH* object = topBuilder->getBVH(objectID_); assert(object);
+          Mesh* mesh = topBuilder->getMesh(objectID_);
+
+          /* the top-level hierarchy references nodes of the object BVH, thus only a refit keeps it valid */
+          if (quality_ != RTC_BUILD_QUALITY_REFIT || topBuilder->useMortonBuilder_ || mesh->topologyChanged(topologyVersion_))
+            return false;
+
+          const unsigned int* leafID = topBuilder->topLevelLeavesBegin(objectID_);
+          const unsigned int* leafEnd = topBuilder->topLevelLeavesEnd(objectID_);
+          if (leafID == leafEnd)
+            return false;
+
+          builder_->build();
+          if (object->getBounds().empty())
+            return false;
+
+          for (; leafID != leafEnd; leafID++)
+          {
+            TopLevelLeaf& leaf = topBuilder->leaves[*leafID];
+            leaf.bounds = nodeBounds(object,mesh,leaf.node);
+            leaf.modified = true;
+          }
+          return true;
+        }
+
+      private:
+
+        /* calculates the bounds of some refitted node of the object BVH */
+        static BBox3fa nodeBounds(BVH* object, Mesh* mesh, NodeRef node)
+        {
+          if (node == object->root)
+            return object->getBounds();
+
+          if (node.isAABBNode())
+            return node.getAABBNode()->bounds();
+
+          BBox3fa bounds = empty;
+          size_t num; Primitive* prims = (Primitive*) node.leaf(num);
+          for (size_t i=0; i<num; i++)
+            bounds.extend(prims[i].update(mesh));
+          return bounds;
+        }
+
       private:
         size_t          objectID_;
         Ref<Builder>    builder_;
         RTCBuildQuality quality_;
+        unsigned int    topologyVersion_ = 0;
       };
 
-      void setupLargeBuildRefBuilder (size_t objectID, Mesh const * const mesh);
-      void setupSmallBuildRefBuilder (size_t objectID, Mesh const * const mesh);
+      bool setupLargeBuildRefBuilder (size_t objectID, Mesh const * const mesh);
+      bool setupSmallBuildRefBuilder (size_t objectID, Mesh const * const mesh);
+
+      /*! refits the top-level hierarchy of the last full build, returns false if a full rebuild is required */
+      bool refitTopLevel ();
+
+      /*! records the top-level hierarchy after a full build */
+      void recordTopLevel (NodeRef root, const BBox3fa& bounds);
+      void recordTopLevelNode (NodeRef ref, unsigned int parent, unsigned int slot);
+
+      const unsigned int* topLevelLeavesBegin (size_t objectID) const {
+        return leafIDs.data() + leafOffsets[objectID];
+      }
+      const unsigned int* topLevelLeavesEnd (size_t objectID) const {
+        return leafIDs.data() + leafOffsets[objectID+1];
+      }
 
       BVH*  getBVH (size_t objectID) {
         return this->bvh->objects[objectID];
@@ -255,6 +385,16 @@ namespace embree
       mvector<BuildRef>   refs;
       mvector<PrimRef>    prims;
       std::atomic<int>    nextRef;
+
+      /* top-level hierarchy of the last full build, used for incremental updates */
+      mvector<TopLevelLeaf> leaves;
+      mvector<TopLevelNode> nodes;
+      mvector<unsigned int> leafIDs;      //!< leaf indices sorted by geometry ID
+      mvector<unsigned int> leafOffsets;  //!< start of the leaf indices of each geometry
+      std::atomic<size_t> nextLeaf;
+      double topLevelArea = 0.0;          //!< sum of the half areas of all top-level nodes
+      float  topLevelSAH = 0.0f;          //!< relative SAH cost after the last full build
+      bool   topLevelValid = false;       //!< true if the top-level hierarchy can get refitted
       const size_t        singleThreadThreshold;
       Geometry::GTypeMask gtype;
       bool                useMortonBuilder_ = false;
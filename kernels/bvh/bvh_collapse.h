@@ -0,0 +1,280 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh.h"
+#include "../builders/bvh_builder_sah.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /* Collapses a binary SAH BVH into a BVH of branching factor N. The
+     * binary BVH is built by one of the generic SAH builders using the
+     * callbacks of this class, or by any other builder that initializes
+     * binary nodes bottom up. This computes bottom up the minimal SAH
+     * cost to represent each binary subtree by at most 1 to N subtrees
+     * (dynamic programming collapse of Ylitie et al. 2017). The wide BVH
+     * is then created top down from the recorded optimal decisions. */
+    template<int N>
+    class BVHNCollapse
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AABBNode AABBNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+      static const unsigned int invalidNode = 0xFFFFFFFF;
+
+    public:
+
+      /*! maximum number of primitives of a leaf that gets merged from multiple binary leaves */
+      static const size_t MAX_LEAF_SIZE = 64;
+
+      struct BinaryNode
+      {
+        BBox3fa bounds;            //!< bounds of the subtree
+        float cost[N];             //!< cost[i] is the minimal SAH cost to represent the subtree by at most i+1 subtrees
+        unsigned char split[N];    //!< number of subtrees assigned to the left child for cost[i], 0 if cost[i-1] is not exceeded
+        unsigned char innerSplit;  //!< number of subtrees assigned to the left child when the subtree becomes an inner node
+        bool leaf;                 //!< true if the subtree becomes a single leaf
+        unsigned int child[2];     //!< children, or invalidNode for binary leaves
+        size_t begin, end;         //!< primitive range of binary leaves
+        size_t size;               //!< number of primitives of the subtree
+      };
+
+      /*! allocator of the binary build, the collapse itself allocates binary nodes from a shared array */
+      struct CreateAlloc
+      {
+        __forceinline CreateAlloc (BVHNCollapse* collapse) : collapse(collapse) {}
+        __forceinline BVHNCollapse* operator() () const { return collapse; }
+        BVHNCollapse* collapse;
+      };
+
+      struct CreateNode
+      {
+        template<typename BuildRecord>
+        __forceinline unsigned int operator() (BuildRecord* children, const size_t num, BVHNCollapse* collapse) const
+        {
+          assert(num == 2);
+          return collapse->allocNode();
+        }
+      };
+
+      struct UpdateNode
+      {
+        __forceinline UpdateNode (BVHNCollapse* collapse) : collapse(collapse) {}
+
+        template<typename BuildRecord>
+        __forceinline unsigned int operator() (const BuildRecord& precord, const BuildRecord* crecords, unsigned int ref, unsigned int* children, const size_t num) const
+        {
+          assert(num == 2);
+          collapse->setInnerNode(ref,precord.prims.geomBounds,children[0],children[1]);
+          return ref;
+        }
+
+        BVHNCollapse* collapse;
+      };
+
+      struct CreateLeaf
+      {
+        __forceinline unsigned int operator() (const PrimRef* prims, const range<size_t>& set, BVHNCollapse* collapse) const
+        {
+          BBox3fa bounds(empty);
+          for (size_t i=set.begin(); i<set.end(); i++)
+            bounds.extend(prims[i].bounds());
+          const unsigned int ref = collapse->allocNode();
+          collapse->setLeafNode(ref,bounds,set);
+          return ref;
+        }
+      };
+
+    public:
+
+      /*! maxPrims is the size of the primref array including space for spatial splits */
+      BVHNCollapse (BVH* bvh, size_t maxPrims, const GeneralBVHBuilder::Settings& settings)
+        : bvh(bvh), nodes(bvh->device,2*max(maxPrims,size_t(1))), numNodes(0), settings(settings),
+          maxLeafSize(min(settings.maxLeafSize,MAX_LEAF_SIZE)) {}
+
+      /*! settings for the binary build, one traversal step of the wide BVH replaces about log2(N) binary steps */
+      GeneralBVHBuilder::Settings binarySettings() const
+      {
+        GeneralBVHBuilder::Settings s = settings;
+        s.branchingFactor = 2;
+        s.maxDepth = 2*BVH::maxBuildDepthLeaf;
+        s.minLeafSize = 1;
+        s.travCost = settings.travCost/float(bsr(N));
+        return s;
+      }
+
+      CreateAlloc createAlloc() { return CreateAlloc(this); }
+      CreateNode createNode() const { return CreateNode(); }
+      UpdateNode updateNode() { return UpdateNode(this); }
+      CreateLeaf createLeaf() const { return CreateLeaf(); }
+
+      /*! creates the wide BVH for the binary BVH of the given root */
+      template<typename CreateLeafFunc>
+      NodeRef collapse(unsigned int root, const PrimRef* prims, const CreateLeafFunc& createLeaf)
+      {
+        return createWide(root,prims,createLeaf,bvh->alloc.getCachedAllocator(),1);
+      }
+
+      /*! allocates a binary node, used by binary builders that do not go through the callbacks above */
+      __forceinline unsigned int allocNode()
+      {
+        const size_t ref = numNodes++;
+        assert(ref < nodes.size());
+        return (unsigned int) ref;
+      }
+
+      /*! initializes a binary leaf referencing a range of primitives */
+      void setLeafNode(unsigned int ref, const BBox3fa& bounds, const range<size_t>& set)
+      {
+        BinaryNode& node = nodes[ref];
+        node.bounds = bounds;
+        node.child[0] = node.child[1] = invalidNode;
+        node.begin = set.begin();
+        node.end = set.end();
+        node.size = set.size();
+        node.leaf = true;
+        node.innerSplit = 0;
+        const float cost = leafCost(bounds,set.size());
+        for (size_t i=0; i<N; i++) {
+          node.cost[i] = cost;
+          node.split[i] = 0;
+        }
+      }
+
+      /*! initializes a binary inner node, which has to happen after its children got initialized */
+      void setInnerNode(unsigned int ref, const BBox3fa& bounds, unsigned int left, unsigned int right)
+      {
+        BinaryNode& node = nodes[ref];
+        const BinaryNode& lnode = nodes[left];
+        const BinaryNode& rnode = nodes[right];
+        node.bounds = bounds;
+        node.child[0] = left;
+        node.child[1] = right;
+        node.begin = node.end = 0;
+        node.size = lnode.size+rnode.size;
+
+        /* minimal cost to distribute i subtrees among both children */
+        float dist[N+1];
+        unsigned char distSplit[N+1];
+        for (size_t i=2; i<=N; i++)
+        {
+          dist[i] = inf; distSplit[i] = 1;
+          for (size_t k=1; k<i; k++)
+          {
+            const float c = lnode.cost[k-1]+rnode.cost[i-k-1];
+            if (c < dist[i]) { dist[i] = c; distSplit[i] = (unsigned char) k; }
+          }
+        }
+
+        /* the subtree as a whole becomes either a leaf or an inner node */
+        const float lcost = node.size <= maxLeafSize ? leafCost(bounds,node.size) : float(inf);
+        const float icost = settings.travCost*halfArea(bounds)+dist[N];
+        node.leaf = lcost <= icost;
+        node.innerSplit = distSplit[N];
+        node.cost[0] = min(lcost,icost);
+        node.split[0] = 0;
+
+        /* or gets split into at most i subtrees */
+        for (size_t i=2; i<=N; i++)
+        {
+          if (dist[i] < node.cost[i-2]) {
+            node.cost[i-1] = dist[i];
+            node.split[i-1] = distSplit[i];
+          } else {
+            node.cost[i-1] = node.cost[i-2];
+            node.split[i-1] = 0;
+          }
+        }
+      }
+
+    private:
+
+      __forceinline float leafCost(const BBox3fa& bounds, size_t num) const {
+        return settings.intCost*halfArea(bounds)*float((num+((size_t(1) << settings.logBlockSize)-1)) >> settings.logBlockSize);
+      }
+
+      /*! collects the at most i subtrees the binary subtree got assigned to */
+      void collectRoots(unsigned int ref, size_t i, unsigned int* roots, size_t& num) const
+      {
+        const BinaryNode& node = nodes[ref];
+        while (i > 1 && node.split[i-1] == 0) i--;
+        if (i == 1) { roots[num++] = ref; return; }
+        collectRoots(node.child[0],node.split[i-1],roots,num);
+        collectRoots(node.child[1],i-node.split[i-1],roots,num);
+      }
+
+      /*! gathers the primitives of all binary leaves of a subtree */
+      void gatherPrims(unsigned int ref, const PrimRef* prims, PrimRef* dst, size_t& num) const
+      {
+        const BinaryNode& node = nodes[ref];
+        if (node.child[0] == invalidNode) {
+          for (size_t i=node.begin; i<node.end; i++) dst[num++] = prims[i];
+          return;
+        }
+        gatherPrims(node.child[0],prims,dst,num);
+        gatherPrims(node.child[1],prims,dst,num);
+      }
+
+      template<typename CreateLeafFunc>
+      NodeRef createWide(unsigned int ref, const PrimRef* prims, const CreateLeafFunc& createLeaf, const FastAllocator::CachedAllocator& alloc, size_t depth)
+      {
+        const BinaryNode& node = nodes[ref];
+        if (depth > BVH::maxBuildDepthLeaf)
+          throw_RTCError(RTC_ERROR_UNKNOWN,"depth limit reached");
+
+        /* leaves of multiple binary leaves operate on a gathered copy of their primitives */
+        if (node.leaf)
+        {
+          if (node.child[0] == invalidNode)
+            return createLeaf(prims,range<size_t>(node.begin,node.end),alloc);
+
+          assert(node.size <= MAX_LEAF_SIZE);
+          PrimRef leafPrims[MAX_LEAF_SIZE];
+          size_t num = 0;
+          gatherPrims(ref,prims,leafPrims,num);
+          return createLeaf(leafPrims,range<size_t>(0,num),alloc);
+        }
+
+        unsigned int roots[N];
+        size_t numRoots = 0;
+        collectRoots(node.child[0],node.innerSplit,roots,numRoots);
+        collectRoots(node.child[1],N-node.innerSplit,roots,numRoots);
+
+        /* sort children for faster shadow ray traversal */
+        for (size_t i=1; i<numRoots; i++)
+          for (size_t j=i; j>0 && nodes[roots[j-1]].size < nodes[roots[j]].size; j--)
+            std::swap(roots[j-1],roots[j]);
+
+        AABBNode* wide = (AABBNode*) alloc.malloc0(sizeof(AABBNode),NodeRef::byteNodeAlignment); wide->clear();
+        for (size_t i=0; i<numRoots; i++)
+          wide->setBounds(i,nodes[roots[i]].bounds);
+
+        if (node.size > settings.singleThreadThreshold)
+        {
+          parallel_for(size_t(0), numRoots, [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+                wide->setRef(i,createWide(roots[i],prims,createLeaf,bvh->alloc.getCachedAllocator(),depth+1));
+            });
+        }
+        else
+        {
+          for (size_t i=0; i<numRoots; i++)
+            wide->setRef(i,createWide(roots[i],prims,createLeaf,alloc,depth+1));
+        }
+        return NodeRef::encodeNode(wide);
+      }
+
+    private:
+      BVH* bvh;
+      mvector<BinaryNode> nodes;
+      std::atomic<size_t> numNodes;
+      GeneralBVHBuilder::Settings settings;
+      const size_t maxLeafSize;
+    };
+  }
+}
@@ -12,7 +12,8 @@ namespace embree
   {
 #define CSTAT(x)
 
-    size_t parallel_depth_threshold = 3;
+    /*! BVH subtrees with fewer primitives are collided by a single thread */
+    static const size_t collide_single_thread_threshold = 256;
     CSTAT(std::atomic<size_t> bvh_collide_traversal_steps(0));
     CSTAT(std::atomic<size_t> bvh_collide_leaf_pairs(0));
     CSTAT(std::atomic<size_t> bvh_collide_leaf_iterations(0));
@@ -72,6 +73,59 @@ namespace embree
       return movemask((lower_x <= upper_x) & (lower_y <= upper_y) & (lower_z <= upper_z));
     }
 
+    /*! returns the depth up to which subtrees of a BVH are large enough for parallel collision */
+    template<int N>
+    __forceinline size_t parallelTreeDepth(size_t numPrimitives)
+    {
+      size_t depth = 0;
+      for (size_t n=numPrimitives; n > collide_single_thread_threshold; n /= N)
+        depth++;
+      return depth;
+    }
+
+    template<int N>
+    BVHNCollider<N>::BVHNCollider (BVH* bvh0, BVH* bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args)
+      : scene0(bvh0->scene), scene1(bvh1->scene), callback(callback), userPtr(userPtr),
+        parallelDepth(parallelTreeDepth<N>(bvh0->numPrimitives)+parallelTreeDepth<N>(bvh1->numPrimitives)), batchSize(0)
+    {
+      if (args && (args->flags & RTC_COLLIDE_FLAG_BUFFERED)) {
+        batchSize = max(size_t(args->batchSize),size_t(16));
+        buffers.resize(TaskScheduler::threadCount());
+      }
+    }
+
+    template<int N>
+    void BVHNCollider<N>::report(RTCCollision* collisions, size_t num)
+    {
+      /* unbuffered mode, or thread not part of the task scheduler */
+      const size_t threadIndex = batchSize ? TaskScheduler::threadIndex() : size_t(-1);
+      if (threadIndex >= buffers.size()) {
+        callback(userPtr,collisions,(unsigned int)num);
+        return;
+      }
+
+      std::vector<RTCCollision>& buffer = buffers[threadIndex].collisions;
+      if (unlikely(buffer.capacity() == 0))
+        buffer.reserve(batchSize+16);
+
+      buffer.insert(buffer.end(),collisions,collisions+num);
+      if (buffer.size() >= batchSize) {
+        callback(userPtr,buffer.data(),(unsigned int)buffer.size());
+        buffer.clear();
+      }
+    }
+
+    template<int N>
+    void BVHNCollider<N>::flush()
+    {
+      for (auto& buffer : buffers)
+      {
+        if (buffer.collisions.size())
+          callback(userPtr,buffer.collisions.data(),(unsigned int)buffer.collisions.size());
+        buffer.collisions.clear();
+      }
+    }
+
     bool intersect_triangle_triangle (Scene* scene0, unsigned geomID0, unsigned primID0, Scene* scene1, unsigned geomID1, unsigned primID1)
     {
       CSTAT(bvh_collide_prim_intersections1++);
@@ -126,13 +180,134 @@ namespace embree
           if (this->scene0 == this->scene1 && geomID0 == geomID1 && primID0 == primID1) continue;
           collisions[num_collisions++] = Collision(geomID0,primID0,geomID1,primID1);
           if (num_collisions == 16) {
-            this->callback(this->userPtr,(RTCCollision*)&collisions,num_collisions);
+            this->report((RTCCollision*)&collisions,num_collisions);
             num_collisions = 0;
           }
         }
       }
       if (num_collisions)
-        this->callback(this->userPtr,(RTCCollision*)&collisions,num_collisions);
+        this->report((RTCCollision*)&collisions,num_collisions);
+    }
+
+    /*! access to the triangles stored in triangle and quad leaves */
+    template<typename Primitive>
+    struct CollideTriangles {};
+
+    template<>
+    struct CollideTriangles<Triangle4>
+    {
+      typedef TriangleMesh Mesh;
+      static const size_t numTriangles = 1;
+
+      static __forceinline void get(const Triangle4& prim, size_t t, Vec3vf4& v0, Vec3vf4& v1, Vec3vf4& v2) {
+        v0 = prim.v0; v1 = prim.v0-prim.e1; v2 = prim.v0+prim.e2;
+      }
+
+      /* triangles of the same mesh that share a vertex touch each other and are ignored */
+      static __forceinline bool neighbors(const Mesh* mesh, unsigned primID0, unsigned primID1)
+      {
+        const TriangleMesh::Triangle& tri0 = mesh->triangle(primID0);
+        const TriangleMesh::Triangle& tri1 = mesh->triangle(primID1);
+        const vint4 t0(tri0.v[0],tri0.v[1],tri0.v[2],tri0.v[2]);
+        return any(vint4(tri1.v[0]) == t0) || any(vint4(tri1.v[1]) == t0) || any(vint4(tri1.v[2]) == t0);
+      }
+    };
+
+    template<>
+    struct CollideTriangles<Triangle4v>
+    {
+      typedef TriangleMesh Mesh;
+      static const size_t numTriangles = 1;
+
+      static __forceinline void get(const Triangle4v& prim, size_t t, Vec3vf4& v0, Vec3vf4& v1, Vec3vf4& v2) {
+        v0 = prim.v0; v1 = prim.v1; v2 = prim.v2;
+      }
+
+      static __forceinline bool neighbors(const Mesh* mesh, unsigned primID0, unsigned primID1) {
+        return CollideTriangles<Triangle4>::neighbors(mesh,primID0,primID1);
+      }
+    };
+
+    template<>
+    struct CollideTriangles<Quad4v>
+    {
+      typedef QuadMesh Mesh;
+      static const size_t numTriangles = 2;
+
+      static __forceinline void get(const Quad4v& prim, size_t t, Vec3vf4& v0, Vec3vf4& v1, Vec3vf4& v2)
+      {
+        if (t == 0) { v0 = prim.v0; v1 = prim.v1; v2 = prim.v3; }
+        else        { v0 = prim.v2; v1 = prim.v3; v2 = prim.v1; }
+      }
+
+      /* quads of the same mesh that share a vertex touch each other and are ignored */
+      static __forceinline bool neighbors(const Mesh* mesh, unsigned primID0, unsigned primID1)
+      {
+        const QuadMesh::Quad& quad0 = mesh->quad(primID0);
+        const QuadMesh::Quad& quad1 = mesh->quad(primID1);
+        const vint4 q0(quad0.v[0],quad0.v[1],quad0.v[2],quad0.v[3]);
+        return any(vint4(quad1.v[0]) == q0) || any(vint4(quad1.v[1]) == q0) || any(vint4(quad1.v[2]) == q0) || any(vint4(quad1.v[3]) == q0);
+      }
+    };
+
+    template<int N, typename Primitive>
+    void BVHNColliderTriangles<N,Primitive>::processLeaf(NodeRef node0, NodeRef node1)
+    {
+      typedef CollideTriangles<Primitive> Triangles;
+      Collision collisions[16];
+      size_t num_collisions = 0;
+
+      size_t N0; const Primitive* leaf0 = (const Primitive*) node0.leaf(N0);
+      size_t N1; const Primitive* leaf1 = (const Primitive*) node1.leaf(N1);
+      for (size_t i=0; i<N0; i++)
+      {
+        for (size_t k0=0; k0<leaf0[i].size(); k0++)
+        {
+          const unsigned geomID0 = leaf0[i].geomID(k0);
+          const unsigned primID0 = leaf0[i].primID(k0);
+
+          /* load the triangles of the primitive of the first leaf */
+          Vec3fa a[Triangles::numTriangles][3];
+          for (size_t t=0; t<Triangles::numTriangles; t++) {
+            Vec3vf4 v0,v1,v2; Triangles::get(leaf0[i],t,v0,v1,v2);
+            a[t][0] = Vec3fa(v0.x[k0],v0.y[k0],v0.z[k0]);
+            a[t][1] = Vec3fa(v1.x[k0],v1.y[k0],v1.z[k0]);
+            a[t][2] = Vec3fa(v2.x[k0],v2.y[k0],v2.z[k0]);
+          }
+
+          /* intersect with all primitives of the second leaf in SIMD */
+          for (size_t j=0; j<N1; j++)
+          {
+            const vbool4 valid = leaf1[j].valid();
+            vbool4 hit(false);
+            for (size_t t1=0; t1<Triangles::numTriangles; t1++) {
+              Vec3vf4 b0,b1,b2; Triangles::get(leaf1[j],t1,b0,b1,b2);
+              for (size_t t0=0; t0<Triangles::numTriangles; t0++)
+                hit |= TriangleTriangleIntersector::intersect_triangle_triangle<4>(valid & !hit,a[t0][0],a[t0][1],a[t0][2],b0,b1,b2);
+            }
+
+            for (size_t m=movemask(hit), k1=bsf(m); m!=0; m=btc(m,k1), k1=bsf(m))
+            {
+              const unsigned geomID1 = leaf1[j].geomID(k1);
+              const unsigned primID1 = leaf1[j].primID(k1);
+
+              /* special culling for scene intersection with itself */
+              if (this->scene0 == this->scene1 && geomID0 == geomID1) {
+                if (primID0 == primID1) continue;
+                if (Triangles::neighbors(this->scene0->template get<typename Triangles::Mesh>(geomID0),primID0,primID1)) continue;
+              }
+
+              collisions[num_collisions++] = Collision(geomID0,primID0,geomID1,primID1);
+              if (num_collisions == 16) {
+                this->report((RTCCollision*)&collisions,num_collisions);
+                num_collisions = 0;
+              }
+            }
+          }
+        }
+      }
+      if (num_collisions)
+        this->report((RTCCollision*)&collisions,num_collisions);
     }
 
     template<int N>
@@ -163,20 +338,18 @@ namespace embree
       recurse_node0:
         AABBNode* node0 = ref0.getAABBNode();
         size_t mask = overlap<N>(bounds1,*node0);
-        //for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
-        //for (size_t i=0; i<N; i++) {
-#if 0
-        if (depth0 < parallel_depth_threshold) 
+
+        /* large node pairs get subdivided into tasks, such that idle threads can steal the work */
+        if (depth0+depth1 < parallelDepth && (mask & (mask-1)))
         {
           parallel_for(size_t(N), [&] ( size_t i ) {
-              if (mask & ( 1 << i)) {
+              if (mask & (size_t(1) << i)) {
                 BVHN<N>::prefetch(node0->child(i),BVH_FLAG_ALIGNED_NODE);
                 collide_recurse(node0->child(i),node0->bounds(i),ref1,bounds1,depth0+1,depth1);
               }
             });
         } 
         else
-#endif
         {
           for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
             BVHN<N>::prefetch(node0->child(i),BVH_FLAG_ALIGNED_NODE);
@@ -190,20 +363,18 @@ namespace embree
       recurse_node1:
         AABBNode* node1 = ref1.getAABBNode();
         size_t mask = overlap<N>(bounds0,*node1);
-        //for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
-        //for (size_t i=0; i<N; i++) {
-#if 0
-        if (depth1 < parallel_depth_threshold) 
+
+        /* large node pairs get subdivided into tasks, such that idle threads can steal the work */
+        if (depth0+depth1 < parallelDepth && (mask & (mask-1)))
         {
           parallel_for(size_t(N), [&] ( size_t i ) {
-              if (mask & ( 1 << i)) {
+              if (mask & (size_t(1) << i)) {
                 BVHN<N>::prefetch(node1->child(i),BVH_FLAG_ALIGNED_NODE);
                 collide_recurse(ref0,bounds0,node1->child(i),node1->bounds(i),depth0,depth1+1);
               }
             });
         }
         else
-#endif
         {
           for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
             BVHN<N>::prefetch(node1->child(i),BVH_FLAG_ALIGNED_NODE);
@@ -306,9 +477,11 @@ namespace embree
           CollideJob& j = jobs[source][i];
           collide_recurse(j.ref0,j.bounds0,j.ref1,j.bounds1,j.depth0,j.depth1);
         });
-      
-      
 #endif
+
+      /* report collisions remaining in the per thread buffers */
+      flush();
+
       CSTAT(PRINT(bvh_collide_traversal_steps));
       CSTAT(PRINT(bvh_collide_leaf_pairs));
       CSTAT(PRINT(bvh_collide_leaf_iterations));
@@ -321,9 +494,16 @@ namespace embree
     }
    
     template<int N>
-    void BVHNColliderUserGeom<N>::collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr)
+    void BVHNColliderUserGeom<N>::collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args)
     { 
-      BVHNColliderUserGeom<N>(bvh0->scene,bvh1->scene,callback,userPtr).
+      BVHNColliderUserGeom<N>(bvh0,bvh1,callback,userPtr,args).
+        collide_recurse_entry(bvh0->root,bvh0->bounds.bounds(),bvh1->root,bvh1->bounds.bounds());
+    }
+
+    template<int N, typename Primitive>
+    void BVHNColliderTriangles<N,Primitive>::collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args)
+    { 
+      BVHNColliderTriangles<N,Primitive>(bvh0,bvh1,callback,userPtr,args).
         collide_recurse_entry(bvh0->root,bvh0->bounds.bounds(),bvh1->root,bvh1->bounds.bounds());
     }
 
@@ -357,6 +537,25 @@ namespace embree
                                                Vec3fa( 2,0.5f,0) + Vec3fa(0,0,0),Vec3fa( 2,0.5f,0) + Vec3fa(0.1f,0,0),Vec3fa( 2,0.5f,0) + Vec3fa(0,0.1f,0)) == false;
         passed &= TriangleTriangleIntersector::intersect_triangle_triangle (Vec3fa(0,0,0),Vec3fa(1,0,0),Vec3fa(0,1,0), 
                                                Vec3fa(0.5f,-2.0f,0) + Vec3fa(0,0,0),Vec3fa(0.5f,-2.0f,0) + Vec3fa(0.1f,0,0),Vec3fa(0.5f,-2.0f,0) + Vec3fa(0,0.1f,0)) == false;
+
+        /* SIMD triangle test has to agree with the single triangle test */
+        unsigned int seed = 1;
+        auto rnd = [&] () { seed = 1103515245*seed + 12345; return float((seed >> 8) & 0xFFFF)/float(0xFFFF); };
+        for (size_t i=0; i<1000; i++)
+        {
+          const Vec3fa a0(rnd(),rnd(),rnd()), a1(rnd(),rnd(),rnd()), a2(rnd(),rnd(),rnd());
+          Vec3fa b[4][3];
+          Vec3vf4 b0,b1,b2;
+          for (size_t k=0; k<4; k++) {
+            for (size_t j=0; j<3; j++) b[k][j] = Vec3fa(rnd(),rnd(),rnd());
+            b0.x[k] = b[k][0].x; b0.y[k] = b[k][0].y; b0.z[k] = b[k][0].z;
+            b1.x[k] = b[k][1].x; b1.y[k] = b[k][1].y; b1.z[k] = b[k][1].z;
+            b2.x[k] = b[k][2].x; b2.y[k] = b[k][2].y; b2.z[k] = b[k][2].z;
+          }
+          const vbool4 hit = TriangleTriangleIntersector::intersect_triangle_triangle<4>(vbool4(true),a0,a1,a2,b0,b1,b2);
+          for (size_t k=0; k<4; k++)
+            passed &= hit[k] == TriangleTriangleIntersector::intersect_triangle_triangle(a0,a1,a2,b[k][0],b[k][1],b[k][2]);
+        }
         return passed;
       }
     };
@@ -369,9 +568,15 @@ namespace embree
     ////////////////////////////////////////////////////////////////////////////////
 
     DEFINE_COLLIDER(BVH4ColliderUserGeom,BVHNColliderUserGeom<4>);
+    IF_ENABLED_TRIS(DEFINE_COLLIDER(BVH4ColliderTriangle4,BVHNColliderTriangles<4 COMMA Triangle4>));
+    IF_ENABLED_TRIS(DEFINE_COLLIDER(BVH4ColliderTriangle4v,BVHNColliderTriangles<4 COMMA Triangle4v>));
+    IF_ENABLED_QUADS(DEFINE_COLLIDER(BVH4ColliderQuad4v,BVHNColliderTriangles<4 COMMA Quad4v>));
 
 #if defined(__AVX__)
     DEFINE_COLLIDER(BVH8ColliderUserGeom,BVHNColliderUserGeom<8>);
+    IF_ENABLED_TRIS(DEFINE_COLLIDER(BVH8ColliderTriangle4,BVHNColliderTriangles<8 COMMA Triangle4>));
+    IF_ENABLED_TRIS(DEFINE_COLLIDER(BVH8ColliderTriangle4v,BVHNColliderTriangles<8 COMMA Triangle4v>));
+    IF_ENABLED_QUADS(DEFINE_COLLIDER(BVH8ColliderQuad4v,BVHNColliderTriangles<8 COMMA Quad4v>));
 #endif
   }
 }
@@ -4,7 +4,9 @@
 #pragma once
 
 #include "bvh.h"
+#include "../geometry/triangle.h"
 #include "../geometry/trianglev.h"
+#include "../geometry/quadv.h"
 #include "../geometry/object.h"
 
 namespace embree
@@ -36,22 +38,37 @@ namespace embree
 
       typedef vector_t<CollideJob, aligned_allocator<CollideJob,16>> jobvector;
 
+      /*! per thread buffer of collisions that get reported in batches */
+      struct CollisionBuffer
+      {
+        std::vector<RTCCollision> collisions;
+        char align[64-sizeof(std::vector<RTCCollision>)]; // avoids false sharing between threads
+      };
+
       void split(const CollideJob& job, jobvector& jobs);
       
     public:
-      __forceinline BVHNCollider (Scene* scene0, Scene* scene1, RTCCollideFunc callback, void* userPtr)
-        : scene0(scene0), scene1(scene1), callback(callback), userPtr(userPtr) {}
+      BVHNCollider (BVH* bvh0, BVH* bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args);
 
     public:
       virtual void processLeaf(NodeRef leaf0, NodeRef leaf1) = 0;
       void collide_recurse(NodeRef node0, const BBox3fa& bounds0, NodeRef node1, const BBox3fa& bounds1, size_t depth0, size_t depth1);
       void collide_recurse_entry(NodeRef node0, const BBox3fa& bounds0, NodeRef node1, const BBox3fa& bounds1);
+
+      /*! reports collisions of one leaf pair to the user, either directly or through the per thread buffers */
+      void report(RTCCollision* collisions, size_t num);
+
+      /*! reports all collisions that are still buffered */
+      void flush();
     
     protected:
       Scene* scene0;
       Scene* scene1;
       RTCCollideFunc callback;
       void* userPtr;
+      size_t parallelDepth;  //!< node pairs above this summed depth get subdivided in parallel
+      size_t batchSize;      //!< number of collisions per callback in buffered mode
+      std::vector<CollisionBuffer> buffers;
     };
 
     template<int N>
@@ -61,12 +78,28 @@ namespace embree
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::AABBNode AABBNode;
 
-      __forceinline BVHNColliderUserGeom (Scene* scene0, Scene* scene1, RTCCollideFunc callback, void* userPtr)
-        : BVHNCollider<N>(scene0,scene1,callback,userPtr) {}
+      __forceinline BVHNColliderUserGeom (BVH* bvh0, BVH* bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args)
+        : BVHNCollider<N>(bvh0,bvh1,callback,userPtr,args) {}
+
+      virtual void processLeaf(NodeRef leaf0, NodeRef leaf1);
+    public:
+      static void collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args);
+    };
+
+    /*! collider for triangle and quad leaves, performs the exact triangle/triangle test before reporting a pair */
+    template<int N, typename Primitive>
+      class BVHNColliderTriangles : public BVHNCollider<N>
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+      typedef typename BVH::AABBNode AABBNode;
+
+      __forceinline BVHNColliderTriangles (BVH* bvh0, BVH* bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args)
+        : BVHNCollider<N>(bvh0,bvh1,callback,userPtr,args) {}
 
       virtual void processLeaf(NodeRef leaf0, NodeRef leaf1);
     public:
-      static void collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr);
+      static void collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args);
     };
   }
 }
@@ -3,6 +3,7 @@
 
 #include "bvh_intersector1.h"
 #include "node_intersector1.h"
+#include "node_intersector_packet.h"
 #include "bvh_traverser1.h"
 
 #include "../geometry/intersector_iterators.h"
@@ -19,6 +20,7 @@
 #include "../geometry/subdivpatch1_intersector.h"
 #include "../geometry/object_intersector.h"
 #include "../geometry/instance_intersector.h"
+#include "../geometry/instance_array_intersector.h"
 #include "../geometry/subgrid_intersector.h"
 #include "../geometry/subgrid_mb_intersector.h"
 #include "../geometry/curve_intersector_virtual.h"
@@ -293,22 +295,169 @@ namespace embree
         }
         return changed;
       }
+
+      static const size_t stackSizeK = 1+(N-1)*BVH::maxDepth+VSIZEX; // +VSIZEX for lazy nodes of each query
+
+      /*! traverses up to K sphere point queries together, node distances are computed for all
+       *  queries at once, while leaves get processed by the single point query primitive code */
+      template<int K>
+      static __forceinline bool pointQueryK(const Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t numQueries)
+      {
+        const BVH* __restrict__ bvh = (const BVH*)This->ptr;
+
+        /* we may traverse an empty BVH in case all geometry was invalid */
+        if (bvh->root == BVH::emptyNode)
+          return false;
+
+        /* load the point queries into SIMD registers, AABB queries and node
+         * types without packet support are traversed one query at a time */
+        bool changed = false;
+        Vec3vf<K> p(zero);
+        vfloat<K> time(zero);
+        vfloat<K> cull_radius(neg_inf);
+        TravPointQuery<N> tquery[K];
+
+        for (size_t k=0; k<numQueries; k++)
+        {
+          PointQuery* query = queries[k];
+          if (!query) continue;
+
+          if (!BVHNNodePointQuerySphereK<N,K,types>::enabled || contexts[k]->query_type != POINT_QUERY_TYPE_SPHERE) {
+            changed |= pointQuery(This, query, contexts[k]);
+            continue;
+          }
+
+          /* verify correct input */
+          assert(!(types & BVH_MB) || (query->time >= 0.0f && query->time <= 1.0f));
+
+          p.x[k] = query->p.x; p.y[k] = query->p.y; p.z[k] = query->p.z;
+          time[k] = query->time;
+          cull_radius[k] = query->radius * query->radius;
+          tquery[k] = TravPointQuery<N>(query->p, contexts[k]->query_radius);
+        }
+
+        const vbool<K> valid = cull_radius >= 0.0f;
+        if (none(valid))
+          return changed;
+
+        /* stack state */
+        NodeRef stack_node[stackSizeK];
+        vfloat<K> stack_dist[stackSizeK];
+        size_t stackPtr = 1;
+        stack_node[0] = bvh->root;
+        stack_dist[0] = select(valid, vfloat<K>(neg_inf), vfloat<K>(pos_inf));
+
+        /* pop loop */
+        while (true) pop:
+        {
+          /* pop next node */
+          if (unlikely(stackPtr == 0)) break;
+          stackPtr--;
+          NodeRef cur = stack_node[stackPtr];
+
+          /* if popped node is too far for all queries, pop next one */
+          vbool<K> active = stack_dist[stackPtr] <= cull_radius;
+          if (unlikely(none(active)))
+            continue;
+
+          /* downtraversal loop */
+          while (likely(!cur.isLeaf()))
+          {
+            STAT3(point_query.trav_nodes,1,popcnt(active),K);
+            const typename BVH::BaseNode* node = cur.baseNode();
+
+            /* continue with the closest child and push all other hit children */
+            NodeRef nextNode = BVH::emptyNode;
+            vfloat<K> nextDist(pos_inf);
+            vbool<K> nextActive(false);
+
+            for (size_t i=0; i<N; i++)
+            {
+              const NodeRef child = node->children[i];
+              if (unlikely(child == BVH::emptyNode)) break;
+
+              vfloat<K> dist; vbool<K> vmask = active;
+              BVHNNodePointQuerySphereK<N,K,types>::pointQuery(cur, i, p, time, cull_radius, dist, vmask);
+              if (likely(none(vmask))) continue;
+
+              const vfloat<K> childDist = select(vmask, dist, vfloat<K>(pos_inf));
+              if (nextNode == BVH::emptyNode) {
+                nextNode = child; nextDist = childDist; nextActive = vmask;
+              }
+              else if (reduce_min(childDist) < reduce_min(nextDist)) {
+                assert(stackPtr < stackSizeK);
+                stack_node[stackPtr] = nextNode; stack_dist[stackPtr] = nextDist; stackPtr++;
+                nextNode = child; nextDist = childDist; nextActive = vmask;
+              }
+              else {
+                assert(stackPtr < stackSizeK);
+                stack_node[stackPtr] = child; stack_dist[stackPtr] = childDist; stackPtr++;
+              }
+            }
+
+            /* if no child is hit, pop next node */
+            if (unlikely(nextNode == BVH::emptyNode))
+              goto pop;
+
+            cur = nextNode;
+            active = nextActive;
+          }
+
+          /* this is a leaf node */
+          assert(cur != BVH::emptyNode);
+          STAT3(point_query.trav_leaves,1,popcnt(active),K);
+          size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+
+          size_t bits = movemask(active);
+          while (bits)
+          {
+            const size_t k = bscf(bits);
+            size_t lazy_node = 0;
+            if (PrimitiveIntersector1::pointQuery(This, queries[k], contexts[k], prim, num, tquery[k], lazy_node))
+            {
+              changed = true;
+              tquery[k].rad = contexts[k]->query_radius;
+              cull_radius[k] = queries[k]->radius * queries[k]->radius;
+            }
+
+            /* push lazy node onto stack for this query only */
+            if (unlikely(lazy_node)) {
+              assert(stackPtr < stackSizeK);
+              stack_node[stackPtr] = lazy_node;
+              stack_dist[stackPtr] = select(vint<K>(step) == vint<K>(int(k)), vfloat<K>(neg_inf), vfloat<K>(pos_inf));
+              stackPtr++;
+            }
+          }
+        }
+        return changed;
+      }
+
+      static __forceinline bool pointQueryN(const Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t num)
+      {
+        bool changed = false;
+        for (size_t i=0; i<num; i+=VSIZEX)
+          changed |= pointQueryK<VSIZEX>(This, queries+i, contexts+i, min(num-i,size_t(VSIZEX)));
+        return changed;
+      }
     };
 
     /* disable point queries for not yet supported geometry types */
     template<int N, int types, bool robust>
     struct PointQueryDispatch<N, types, robust, VirtualCurveIntersector1> {
       static __forceinline bool pointQuery(const Accel::Intersectors* This, PointQuery* query, PointQueryContext* context) { return false; }
+      static __forceinline bool pointQueryN(const Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t num) { return false; }
     };
     
     template<int N, int types, bool robust>
     struct PointQueryDispatch<N, types, robust, SubdivPatch1Intersector1> {
       static __forceinline bool pointQuery(const Accel::Intersectors* This, PointQuery* query, PointQueryContext* context) { return false; }
+      static __forceinline bool pointQueryN(const Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t num) { return false; }
     };
     
     template<int N, int types, bool robust>
     struct PointQueryDispatch<N, types, robust, SubdivPatch1MBIntersector1> {
       static __forceinline bool pointQuery(const Accel::Intersectors* This, PointQuery* query, PointQueryContext* context) { return false; }
+      static __forceinline bool pointQueryN(const Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t num) { return false; }
     };
 
     template<int N, int types, bool robust, typename PrimitiveIntersector1>
@@ -317,5 +466,12 @@ namespace embree
     {
       return PointQueryDispatch<N, types, robust, PrimitiveIntersector1>::pointQuery(This, query, context);
     }
+
+    template<int N, int types, bool robust, typename PrimitiveIntersector1>
+    bool BVHNIntersector1<N, types, robust, PrimitiveIntersector1>::pointQueryN(
+      const Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t num)
+    {
+      return PointQueryDispatch<N, types, robust, PrimitiveIntersector1>::pointQueryN(This, queries, contexts, num);
+    }
   }
 }
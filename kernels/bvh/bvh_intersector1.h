@@ -29,6 +29,7 @@ namespace embree
       static void intersect (const Accel::Intersectors* This, RayHit& ray, RayQueryContext* context);
       static void occluded  (const Accel::Intersectors* This, Ray& ray, RayQueryContext* context);
       static bool pointQuery(const Accel::Intersectors* This, PointQuery* query, PointQueryContext* context);
+      static bool pointQueryN(const Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t num);
     };
   }
 }
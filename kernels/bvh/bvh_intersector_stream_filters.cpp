@@ -0,0 +1,235 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh_intersector_stream_filters.h"
+#include "../common/ray.h"
+#include "../common/scene.h"
+#include <algorithm>
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! rays of a stream are processed in blocks of this size, which keeps 32 bit ray offsets valid for arbitrary long streams */
+    static const size_t MAX_STREAM_BLOCK_SIZE = 4096;
+
+    /*! number of rays buffered per direction octant before they get sorted and traced */
+    static const size_t MAX_OCTANT_RAYS = 16*VSIZEX;
+
+    /*! number of bits per dimension used to quantize ray origins */
+    static const unsigned int ORIGIN_BITS = 10;
+
+    template<int K> __forceinline bool hasIntersectorK(Scene* scene);
+    template<> __forceinline bool hasIntersectorK<4>(Scene* scene) { return scene->intersectors.intersector4; }
+#if defined(__AVX__)
+    template<> __forceinline bool hasIntersectorK<8>(Scene* scene) { return scene->intersectors.intersector8; }
+#endif
+#if defined(__AVX512F__)
+    template<> __forceinline bool hasIntersectorK<16>(Scene* scene) { return scene->intersectors.intersector16; }
+#endif
+
+    __forceinline void traceRay1(Scene* scene, RayHit& ray, RayQueryContext* context) {
+      scene->intersectors.intersect((RTCRayHit&)ray,context);
+    }
+
+    __forceinline void traceRay1(Scene* scene, Ray& ray, RayQueryContext* context) {
+      scene->intersectors.occluded((RTCRay&)ray,context);
+    }
+
+    /*! returns stream with all ray pointers advanced by some byte offset */
+    __forceinline RayStreamAOS advanceStream(const RayStreamAOS& stream, size_t offset)
+    {
+      RayStreamAOS r = stream;
+      r.ptr = (Ray*)((char*)stream.ptr + offset);
+      return r;
+    }
+
+    template<typename T>
+    __forceinline T* advancePtr(T* ptr, size_t offset) {
+      return ptr ? (T*)((char*)ptr + offset) : nullptr;
+    }
+
+    __forceinline RayStreamSOP advanceStream(const RayStreamSOP& stream, size_t offset)
+    {
+      RayStreamSOP r;
+      r.org_x = advancePtr(stream.org_x,offset); r.org_y = advancePtr(stream.org_y,offset); r.org_z = advancePtr(stream.org_z,offset);
+      r.tnear = advancePtr(stream.tnear,offset);
+      r.dir_x = advancePtr(stream.dir_x,offset); r.dir_y = advancePtr(stream.dir_y,offset); r.dir_z = advancePtr(stream.dir_z,offset);
+      r.time  = advancePtr(stream.time,offset);
+      r.tfar  = advancePtr(stream.tfar,offset);
+      r.mask  = advancePtr(stream.mask,offset); r.id = advancePtr(stream.id,offset); r.flags = advancePtr(stream.flags,offset);
+      r.Ng_x  = advancePtr(stream.Ng_x,offset); r.Ng_y = advancePtr(stream.Ng_y,offset); r.Ng_z = advancePtr(stream.Ng_z,offset);
+      r.u     = advancePtr(stream.u,offset); r.v = advancePtr(stream.v,offset);
+      r.primID = advancePtr(stream.primID,offset); r.geomID = advancePtr(stream.geomID,offset);
+      for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+        r.instID[l] = advancePtr(stream.instID[l],offset);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+        r.instPrimID[l] = advancePtr(stream.instPrimID[l],offset);
+#endif
+      return r;
+    }
+
+    /*! creates pointer SOA stream from the API ray and optional hit pointers */
+    __forceinline RayStreamSOP makeStreamSOP(const RTCRayNp& ray, const RTCHitNp* hit)
+    {
+      RayStreamSOP r;
+      r.org_x = ray.org_x; r.org_y = ray.org_y; r.org_z = ray.org_z; r.tnear = ray.tnear;
+      r.dir_x = ray.dir_x; r.dir_y = ray.dir_y; r.dir_z = ray.dir_z; r.time = ray.time;
+      r.tfar = ray.tfar; r.mask = ray.mask; r.id = ray.id; r.flags = ray.flags;
+      r.Ng_x = hit ? hit->Ng_x : nullptr; r.Ng_y = hit ? hit->Ng_y : nullptr; r.Ng_z = hit ? hit->Ng_z : nullptr;
+      r.u = hit ? hit->u : nullptr; r.v = hit ? hit->v : nullptr;
+      r.primID = hit ? hit->primID : nullptr; r.geomID = hit ? hit->geomID : nullptr;
+      for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+        r.instID[l] = hit ? hit->instID[l] : nullptr;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+        r.instPrimID[l] = hit ? hit->instPrimID[l] : nullptr;
+#endif
+      return r;
+    }
+
+    class RayStreamFilter
+    {
+    public:
+      static void intersectAOS(Scene* scene, RTCRayHit* rays, size_t N, size_t stride, RayQueryContext* context);
+      static void intersectSOP(Scene* scene, const RTCRayHitNp& rays, size_t N, RayQueryContext* context);
+
+      static void occludedAOS(Scene* scene, RTCRay* rays, size_t N, size_t stride, RayQueryContext* context);
+      static void occludedSOP(Scene* scene, const RTCRayNp& rays, size_t N, RayQueryContext* context);
+
+    private:
+
+      /*! traces a packet of rays of the stream given by byte offsets */
+      template<bool intersect, typename RayStream>
+      static __forceinline void tracePacket(Scene* scene, RayStream& stream, vboolx valid, const vintx& offset, RayQueryContext* context)
+      {
+        RayTypeK<VSIZEX,intersect> ray;
+        ray = stream.template getRayByOffset<VSIZEX>(valid, offset);
+        valid &= ray.tnear() <= ray.tfar;
+        if (none(valid)) return;
+
+        if (likely(hasIntersectorK<VSIZEX>(scene)))
+          scene->intersectors.intersect(valid,ray,context);
+
+        else
+        {
+          size_t bits = movemask(valid);
+          while (bits != 0)
+          {
+            const size_t k = bscf(bits);
+            RayTypeK<1,intersect> ray1; ray.get(k,ray1);
+            traceRay1(scene,ray1,context);
+            ray.set(k,ray1);
+          }
+        }
+
+        stream.template setHitByOffset<VSIZEX>(valid,offset,ray);
+      }
+
+      /*! sorts the buffered rays of one octant by origin and traces them as packets */
+      template<bool intersect, typename RayStream>
+      static __forceinline void flushOctant(Scene* scene, RayStream& stream, uint64_t* keys, size_t num, size_t stride, RayQueryContext* context)
+      {
+        std::sort(keys,keys+num);
+
+        for (size_t i=0; i<num; i+=VSIZEX)
+        {
+          const size_t n = min(num-i,size_t(VSIZEX));
+          vintx offset(zero);
+          for (size_t k=0; k<n; k++)
+            offset[k] = int((keys[i+k] & 0xFFFFFFFF)*stride);
+          const vboolx valid = vintx(step) < vintx(int(n));
+          tracePacket<intersect>(scene,stream,valid,offset,context);
+        }
+      }
+
+      /*! traces a block of at most MAX_STREAM_BLOCK_SIZE rays */
+      template<bool intersect, typename RayStream>
+      static void filterBlock(Scene* scene, RayStream& stream, size_t N, size_t stride, RayQueryContext* context)
+      {
+        /* coherent rays are traced in the order provided by the application */
+        if (context->isCoherent())
+        {
+          for (size_t i=0; i<N; i+=VSIZEX)
+          {
+            const vintx vi = vintx(int(i))+vintx(step);
+            const vboolx valid = vi < vintx(int(N));
+            const vintx offset = vi*int(stride);
+            tracePacket<intersect>(scene,stream,valid,offset,context);
+          }
+          return;
+        }
+
+        /* incoherent rays get binned by direction octant and sorted by the morton code of their quantized origin */
+        const BBox3fa bounds = scene->bounds.bounds();
+        const Vec3fa base = bounds.lower;
+        const Vec3fa diag = max(Vec3fa(bounds.size()),Vec3fa(1E-19f));
+        const Vec3fa scale = Vec3fa(float((1 << ORIGIN_BITS)-1)) * rcp(diag);
+        const float maxq = float((1 << ORIGIN_BITS)-1);
+
+        uint64_t keys[8][MAX_OCTANT_RAYS];
+        size_t num[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+        for (size_t i=0; i<N; i++)
+        {
+          const Ray ray = stream.getRayByOffset(i*stride);
+          if (unlikely(!(ray.tnear() <= ray.tfar))) continue;
+
+          const size_t octant = (ray.dir.x < 0.0f ? 1 : 0) + (ray.dir.y < 0.0f ? 2 : 0) + (ray.dir.z < 0.0f ? 4 : 0);
+          const unsigned int qx = (unsigned int) clamp((ray.org.x-base.x)*scale.x,0.0f,maxq);
+          const unsigned int qy = (unsigned int) clamp((ray.org.y-base.y)*scale.y,0.0f,maxq);
+          const unsigned int qz = (unsigned int) clamp((ray.org.z-base.z)*scale.z,0.0f,maxq);
+          const unsigned int code = bitInterleave(qx,qy,qz);
+
+          keys[octant][num[octant]++] = (uint64_t(code) << 32) | uint64_t(i);
+          if (num[octant] == MAX_OCTANT_RAYS) {
+            flushOctant<intersect>(scene,stream,keys[octant],num[octant],stride,context);
+            num[octant] = 0;
+          }
+        }
+
+        for (size_t octant=0; octant<8; octant++)
+          if (num[octant]) flushOctant<intersect>(scene,stream,keys[octant],num[octant],stride,context);
+      }
+
+      template<bool intersect, typename RayStream>
+      static void filter(Scene* scene, RayStream& stream, size_t N, size_t stride, RayQueryContext* context)
+      {
+        for (size_t i=0; i<N; i+=MAX_STREAM_BLOCK_SIZE)
+        {
+          RayStream block = advanceStream(stream,i*stride);
+          filterBlock<intersect>(scene,block,min(N-i,MAX_STREAM_BLOCK_SIZE),stride,context);
+        }
+      }
+    };
+
+    void RayStreamFilter::intersectAOS(Scene* scene, RTCRayHit* rays, size_t N, size_t stride, RayQueryContext* context)
+    {
+      RayStreamAOS stream(rays);
+      filter<true>(scene,stream,N,stride,context);
+    }
+
+    void RayStreamFilter::intersectSOP(Scene* scene, const RTCRayHitNp& rays, size_t N, RayQueryContext* context)
+    {
+      RayStreamSOP stream = makeStreamSOP(rays.ray,&rays.hit);
+      filter<true>(scene,stream,N,sizeof(float),context);
+    }
+
+    void RayStreamFilter::occludedAOS(Scene* scene, RTCRay* rays, size_t N, size_t stride, RayQueryContext* context)
+    {
+      RayStreamAOS stream(rays);
+      filter<false>(scene,stream,N,stride,context);
+    }
+
+    void RayStreamFilter::occludedSOP(Scene* scene, const RTCRayNp& rays, size_t N, RayQueryContext* context)
+    {
+      RayStreamSOP stream = makeStreamSOP(rays,nullptr);
+      filter<false>(scene,stream,N,sizeof(float),context);
+    }
+
+    RayStreamFilterFuncs rayStreamFilterFuncs() {
+      return RayStreamFilterFuncs(RayStreamFilter::intersectAOS, RayStreamFilter::intersectSOP, RayStreamFilter::occludedAOS, RayStreamFilter::occludedSOP);
+    }
+  };
+};
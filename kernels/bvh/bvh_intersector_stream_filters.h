@@ -0,0 +1,39 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../common/default.h"
+#include "../common/context.h"
+
+namespace embree
+{
+  class Scene;
+
+  /*! ISA specific stream filter functions, selected once per device */
+  struct RayStreamFilterFuncs
+  {
+    typedef void (*intersectAOSFunc)(Scene* scene, RTCRayHit* rays, size_t N, size_t stride, RayQueryContext* context);
+    typedef void (*intersectSOPFunc)(Scene* scene, const RTCRayHitNp& rays, size_t N, RayQueryContext* context);
+
+    typedef void (*occludedAOSFunc)(Scene* scene, RTCRay* rays, size_t N, size_t stride, RayQueryContext* context);
+    typedef void (*occludedSOPFunc)(Scene* scene, const RTCRayNp& rays, size_t N, RayQueryContext* context);
+
+    RayStreamFilterFuncs()
+      : intersectAOS(nullptr), intersectSOP(nullptr), occludedAOS(nullptr), occludedSOP(nullptr) {}
+
+    RayStreamFilterFuncs(void (*ptr)())
+      : intersectAOS((intersectAOSFunc)ptr), intersectSOP((intersectSOPFunc)ptr), occludedAOS((occludedAOSFunc)ptr), occludedSOP((occludedSOPFunc)ptr) {}
+
+    RayStreamFilterFuncs(intersectAOSFunc intersectAOS, intersectSOPFunc intersectSOP, occludedAOSFunc occludedAOS, occludedSOPFunc occludedSOP)
+      : intersectAOS(intersectAOS), intersectSOP(intersectSOP), occludedAOS(occludedAOS), occludedSOP(occludedSOP) {}
+
+  public:
+    intersectAOSFunc intersectAOS;
+    intersectSOPFunc intersectSOP;
+    occludedAOSFunc occludedAOS;
+    occludedSOPFunc occludedSOP;
+  };
+
+  typedef RayStreamFilterFuncs (*RayStreamFilterFuncsType)();
+}
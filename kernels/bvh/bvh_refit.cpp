@@ -19,6 +19,38 @@ namespace embree
   namespace isa
   {
     static const size_t SINGLE_THREAD_THRESHOLD = 4*1024;
+
+    /* partial refits are used if at most 1/PARTIAL_REFIT_FRACTION of all primitives got modified */
+    static const size_t PARTIAL_REFIT_FRACTION = 4;
+
+    /* iterates over the IDs of all primitives stored in a primitive block */
+    template<typename Primitive>
+    struct PrimitiveIDs
+    {
+      template<typename Closure>
+      static __forceinline void iterate(const Primitive& prim, const Closure& closure) {
+        for (size_t i=0; i<Primitive::max_size() && prim.valid(i); i++)
+          closure(prim.primID(i));
+      }
+    };
+
+    template<>
+    struct PrimitiveIDs<Object>
+    {
+      template<typename Closure>
+      static __forceinline void iterate(const Object& prim, const Closure& closure) {
+        closure(prim.primID());
+      }
+    };
+
+    template<>
+    struct PrimitiveIDs<InstancePrimitive>
+    {
+      template<typename Closure>
+      static __forceinline void iterate(const InstancePrimitive& prim, const Closure& closure) {
+        closure(0);
+      }
+    };
     
     template<int N>
     __forceinline bool compare(const typename BVHN<N>::NodeRef* a, const typename BVHN<N>::NodeRef* b)
@@ -30,7 +62,7 @@ namespace embree
 
     template<int N>
     BVHNRefitter<N>::BVHNRefitter (BVH* bvh, const LeafBoundsInterface& leafBounds)
-      : bvh(bvh), leafBounds(leafBounds), numSubTrees(0)
+      : bvh(bvh), leafBounds(leafBounds), numSubTrees(0), leaves(bvh->device,0), nodes(bvh->device,0), stamp(0)
     {
     }
 
@@ -125,6 +157,91 @@ namespace embree
         return leafBounds.leafBounds(ref);
     }
 
+    template<int N>
+    void BVHNRefitter<N>::gather_tree()
+    {
+      clear_tree();
+      if (bvh->root != BVH::emptyNode)
+        gather_tree_nodes(bvh->root,-1,0);
+    }
+
+    template<int N>
+    void BVHNRefitter<N>::clear_tree()
+    {
+      leaves.resize(0);
+      nodes.resize(0);
+    }
+
+    template<int N>
+    void BVHNRefitter<N>::gather_tree_nodes(NodeRef ref, unsigned int parent, unsigned int slot)
+    {
+      if (ref.isLeaf()) {
+        leaves.push_back(TreeNode(ref,parent,slot));
+        return;
+      }
+
+      AABBNode* node = ref.getAABBNode();
+      const unsigned int index = (unsigned int) nodes.size();
+      nodes.push_back(TreeNode(ref,parent,slot));
+
+      for (unsigned int i=0; i<N; i++) {
+        if (unlikely(node->child(i) == BVH::emptyNode)) continue;
+        gather_tree_nodes(node->child(i),index,i);
+      }
+    }
+
+    template<int N>
+    void BVHNRefitter<N>::refit_leaves(const unsigned int* leafIDs, size_t numLeafIDs)
+    {
+      if (numLeafIDs == 0)
+        return;
+
+      /* a single leaf is the root */
+      if (nodes.size() == 0) {
+        bvh->bounds = LBBox3fa(leafBounds.leafBounds(leaves[0].ref));
+        return;
+      }
+
+      /* update leaves in parallel, different leaves write to different child slots */
+      parallel_for(size_t(0), numLeafIDs, size_t(64), [&](const range<size_t>& r) {
+          for (size_t i=r.begin(); i<r.end(); i++) {
+            TreeNode& leaf = leaves[leafIDs[i]];
+            nodes[leaf.parent].ref.getAABBNode()->setBounds(leaf.slot,leafBounds.leafBounds(leaf.ref));
+          }
+        });
+
+      /* parents are stored before their children, thus processing the largest index first refits bottom-up */
+      stamp++;
+      std::vector<unsigned int> heap;
+      for (size_t i=0; i<numLeafIDs; i++) {
+        TreeNode& parent = nodes[leaves[leafIDs[i]].parent];
+        if (parent.stamp == stamp) continue;
+        parent.stamp = stamp;
+        heap.push_back(leaves[leafIDs[i]].parent);
+      }
+      std::make_heap(heap.begin(),heap.end());
+
+      while (heap.size())
+      {
+        std::pop_heap(heap.begin(),heap.end());
+        TreeNode& node = nodes[heap.back()];
+        heap.pop_back();
+
+        const BBox3fa bounds = node.ref.getAABBNode()->bounds();
+        if (node.parent == (unsigned int)-1) {
+          bvh->bounds = LBBox3fa(bounds);
+          continue;
+        }
+
+        TreeNode& parent = nodes[node.parent];
+        parent.ref.getAABBNode()->setBounds(node.slot,bounds);
+        if (parent.stamp == stamp) continue;
+        parent.stamp = stamp;
+        heap.push_back(node.parent);
+        std::push_heap(heap.begin(),heap.end());
+      }
+    }
+
     // =========================================================
     // =========================================================
     // =========================================================
@@ -170,24 +287,68 @@ namespace embree
 
     template<int N, typename Mesh, typename Primitive>
     BVHNRefitT<N,Mesh,Primitive>::BVHNRefitT (BVH* bvh, Builder* builder, Mesh* mesh, size_t mode)
-      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh), topologyVersion(0) {}
+      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh), topologyVersion(0), modCounter(0), primLeaves(bvh->device,0) {}
 
     template<int N, typename Mesh, typename Primitive>
     void BVHNRefitT<N,Mesh,Primitive>::clear()
     {
       if (builder) 
         builder->clear();
+      refitter->clear_tree();
+      primLeaves.resize(0);
+      topologyVersion = 0;
     }
     
     template<int N, typename Mesh, typename Primitive>
     void BVHNRefitT<N,Mesh,Primitive>::build()
     {
+      range<unsigned int> prims;
       if (mesh->topologyChanged(topologyVersion)) {
         topologyVersion = mesh->getTopologyVersion();
         builder->build();
+        refitter->clear_tree();
+        primLeaves.resize(0);
       }
+      else if (mesh->getModifiedPrimitives(modCounter,prims) && size_t(prims.size())*PARTIAL_REFIT_FRACTION <= mesh->size())
+        refitPrimitives(prims);
       else
         refitter->refit();
+
+      modCounter = mesh->getModCounter();
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNRefitT<N,Mesh,Primitive>::refitPrimitives(const range<unsigned int>& prims)
+    {
+      /* build map from primitives to leaves on first use */
+      if (primLeaves.size() != mesh->size())
+      {
+        refitter->gather_tree();
+        primLeaves.resize(mesh->size());
+        parallel_for(size_t(0), primLeaves.size(), [&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) primLeaves[i] = -1;
+          });
+        parallel_for(size_t(0), refitter->leaves.size(), [&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) {
+              size_t num; Primitive* prim = (Primitive*) refitter->leaves[i].ref.leaf(num);
+              for (size_t j=0; j<num; j++)
+                PrimitiveIDs<Primitive>::iterate(prim[j],[&] (unsigned int primID) { primLeaves[primID] = (unsigned int) i; });
+            }
+          });
+      }
+
+      /* collect leaves of the modified primitives */
+      std::vector<unsigned int> leafIDs;
+      leafIDs.reserve(prims.size());
+      for (unsigned int primID=prims.begin(); primID<prims.end(); primID++) {
+        if (primLeaves[primID] == (unsigned int)-1) continue;
+        if (leafIDs.size() && leafIDs.back() == primLeaves[primID]) continue;
+        leafIDs.push_back(primLeaves[primID]);
+      }
+      std::sort(leafIDs.begin(),leafIDs.end());
+      leafIDs.erase(std::unique(leafIDs.begin(),leafIDs.end()),leafIDs.end());
+
+      refitter->refit_leaves(leafIDs.data(),leafIDs.size());
     }
 
     template class BVHNRefitter<4>;
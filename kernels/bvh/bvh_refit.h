@@ -31,7 +31,19 @@ namespace embree
       /*! refits the BVH */
       void refit();
 
+      /*! gathers all leaves and inner nodes together with their parent links */
+      void gather_tree();
+
+      /*! clears all gathered leaves and nodes */
+      void clear_tree();
+
+      /*! refits only the specified gathered leaves and all their ancestors */
+      void refit_leaves(const unsigned int* leafIDs, size_t numLeafIDs);
+
     private:
+      /* single-threaded gathering of leaves and nodes in pre-order */
+      void gather_tree_nodes(NodeRef ref, unsigned int parent, unsigned int slot);
+
       /* single-threaded subtree extraction based on BVH depth */
       void gather_subtree_refs(NodeRef& ref, 
                                size_t &subtrees,
@@ -54,6 +66,25 @@ namespace embree
       static const size_t MAX_NUM_SUB_TREES             = (N==4) ? 256 : (N==8) ? 512 : N*N*N; // N ^ MAX_SUB_TREE_EXTRACTION_DEPTH
       size_t numSubTrees;
       NodeRef subTrees[MAX_NUM_SUB_TREES];
+
+      /*! leaf or inner node with a link to its parent node */
+      struct TreeNode
+      {
+        __forceinline TreeNode () {}
+
+        __forceinline TreeNode (NodeRef ref, unsigned int parent, unsigned int slot)
+          : ref(ref), parent(parent), slot(slot), stamp(0) {}
+
+      public:
+        NodeRef ref;           //!< leaf or inner node
+        unsigned int parent;   //!< index of the parent inner node, -1 for the root
+        unsigned int slot;     //!< child slot inside the parent node
+        unsigned int stamp;    //!< last partial refit that updated this node
+      };
+
+      mvector<TreeNode> leaves;  //!< gathered leaves
+      mvector<TreeNode> nodes;   //!< gathered inner nodes in pre-order
+      unsigned int stamp;        //!< counter of partial refits
     };
 
     template<int N, typename Mesh, typename Primitive>
@@ -83,6 +114,10 @@ namespace embree
             bounds.extend(((Primitive*)prim)[i].update(mesh));
         return bounds;
       }
+
+    private:
+      /*! refits only the leaves containing the specified primitives */
+      void refitPrimitives(const range<unsigned int>& prims);
       
     private:
       BVH* bvh;
@@ -90,6 +125,8 @@ namespace embree
       std::unique_ptr<BVHNRefitter<N>> refitter;
       Mesh* mesh;
       unsigned int topologyVersion;
+      unsigned int modCounter;             //!< modification counter of the mesh at the last build
+      mvector<unsigned int> primLeaves;    //!< maps primitive IDs to gathered leaves, built on demand
     };
   }
 }
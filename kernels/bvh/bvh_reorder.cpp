@@ -0,0 +1,175 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh_reorder.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! a node waiting to get stored, together with the child slot of its already stored parent */
+    template<typename NodeRef>
+    struct BVHNReorderItem
+    {
+      __forceinline BVHNReorderItem () {}
+
+      __forceinline BVHNReorderItem (NodeRef ref, float area, size_t parent, size_t slot)
+        : ref(ref), area(area), parent(parent), slot(slot) {}
+
+      __forceinline bool operator< (const BVHNReorderItem& other) const {
+        return area < other.area;
+      }
+
+      NodeRef ref;
+      float area;    //!< half surface area used to estimate the probability to get traversed
+      size_t parent; //!< offset of the parent node, or size_t(-1) for the root
+      size_t slot;   //!< child slot of the node in its parent
+    };
+
+    /*! returns the number of bytes of all primitive blocks of a leaf */
+    template<typename NodeRef>
+    static __forceinline size_t leafBytes(const PrimitiveType* primTy, NodeRef ref)
+    {
+      size_t num; const char* prims = ref.leaf(num);
+      size_t bytes = 0;
+      for (size_t i=0; i<num; i++)
+        bytes += primTy->getBytes(prims+bytes);
+      return bytes;
+    }
+
+    template<int N>
+    bool BVHNReorder<N>::reorder(BVH* bvh)
+    {
+      /* BVHs with lazily built parts reference memory outside the allocator */
+      if (!bvh->root.isAABBNode() || bvh->root.isBarrier())
+        return false;
+      if (bvh->objects.size() || bvh->subdiv_patches.size())
+        return false;
+
+      /* count nodes and leaf bytes, all inner nodes have to be AABB nodes */
+      size_t numNodes = 0, numLeaves = 0, numLeafBytes = 0;
+      std::vector<NodeRef> stack;
+      stack.push_back(bvh->root);
+      while (!stack.empty())
+      {
+        NodeRef ref = stack.back(); stack.pop_back();
+        if (ref == BVH::emptyNode) continue;
+        if (ref.isBarrier()) return false;
+        if (ref.isLeaf()) {
+          numLeaves++;
+          numLeafBytes += leafBytes(bvh->primTy,ref);
+          continue;
+        }
+        if (!ref.isAABBNode()) return false;
+        numNodes++;
+        const AABBNode* node = ref.getAABBNode();
+        for (size_t c=0; c<N; c++)
+          stack.push_back(node->child(c));
+      }
+
+      /* upper bound of the new layout, which may need padding to align nodes and leaves */
+      const size_t nodeBytes = sizeof(AABBNode);
+      const size_t maxBytes = numNodes*(nodeBytes+nodeAlignment) + numLeaves*BVH::byteAlignment + numLeafBytes;
+      char* dst = (char*) alignedMalloc(maxBytes,nodeAlignment);
+      size_t cur = 0;
+
+      /* stores a node followed by its leaves, child references are stored as offsets into the new layout */
+      auto store = [&] (const BVHNReorderItem<NodeRef>& item, std::vector<BVHNReorderItem<NodeRef>>& frontier)
+      {
+        const size_t offset = (cur+nodeAlignment-1) & ~(nodeAlignment-1);
+        AABBNode* node = (AABBNode*) (dst+offset);
+        *node = *item.ref.getAABBNode();
+        cur = offset+nodeBytes;
+        if (item.parent != size_t(-1))
+          ((AABBNode*)(dst+item.parent))->child(item.slot) = NodeRef(offset);
+
+        for (size_t c=0; c<N; c++)
+        {
+          const NodeRef child = node->child(c);
+          if (child == BVH::emptyNode) continue;
+          if (child.isLeaf())
+          {
+            const size_t bytes = leafBytes(bvh->primTy,child);
+            const size_t leafOffset = (cur+BVH::byteAlignment-1) & ~(BVH::byteAlignment-1);
+            size_t num; const char* prims = child.leaf(num);
+            memcpy(dst+leafOffset,prims,bytes);
+            node->child(c) = NodeRef(leafOffset | (size_t(child) & size_t(NodeRef::align_mask)));
+            cur = leafOffset+bytes;
+          }
+          else {
+            frontier.push_back(BVHNReorderItem<NodeRef>(child,halfArea(node->bounds(c)),offset,c));
+            std::push_heap(frontier.begin(),frontier.end());
+          }
+        }
+      };
+
+      /* each treelet is grown from its root into the children of largest area until it exceeds the treelet size, the
+       * remaining children become roots of further treelets, which get processed depth first to keep subtrees together */
+      std::vector<BVHNReorderItem<NodeRef>> roots;
+      std::vector<BVHNReorderItem<NodeRef>> frontier;
+      std::vector<BVHNReorderItem<NodeRef>> deferred;
+      roots.push_back(BVHNReorderItem<NodeRef>(bvh->root,inf,size_t(-1),0));
+      while (!roots.empty())
+      {
+        frontier.clear();
+        frontier.push_back(roots.back()); roots.pop_back();
+        deferred.clear();
+
+        const size_t begin = cur;
+        while (!frontier.empty())
+        {
+          std::pop_heap(frontier.begin(),frontier.end());
+          const BVHNReorderItem<NodeRef> item = frontier.back(); frontier.pop_back();
+
+          size_t bytes = nodeBytes;
+          const AABBNode* node = item.ref.getAABBNode();
+          for (size_t c=0; c<N; c++)
+            if (node->child(c) != BVH::emptyNode && node->child(c).isLeaf())
+              bytes += leafBytes(bvh->primTy,node->child(c));
+
+          if (cur > begin && cur-begin+bytes > treeletBytes) {
+            deferred.push_back(item);
+            continue;
+          }
+          store(item,frontier);
+        }
+
+        std::sort(deferred.begin(),deferred.end());
+        roots.insert(roots.end(),deferred.begin(),deferred.end());
+      }
+      assert(cur <= maxBytes);
+
+      /* replace the allocator blocks by a single block holding the new layout */
+      const LBBox3fa bounds = bvh->bounds;
+      const size_t numPrimitives = bvh->numPrimitives;
+      bvh->clear();
+      char* base = (char*) bvh->alloc.mallocBlock(cur);
+      memcpy(base,dst,cur);
+      alignedFree(dst);
+
+      /* relocate the child references */
+      const NodeRef root = NodeRef((size_t)base);
+      stack.push_back(root);
+      while (!stack.empty())
+      {
+        AABBNode* node = stack.back().getAABBNode(); stack.pop_back();
+        for (size_t c=0; c<N; c++)
+        {
+          NodeRef& child = node->child(c);
+          if (child == BVH::emptyNode) continue;
+          child = NodeRef(size_t(child)+(size_t)base);
+          if (!child.isLeaf()) stack.push_back(child);
+        }
+      }
+
+      bvh->alloc.cleanup();
+      bvh->set(root,bounds,numPrimitives);
+      return true;
+    }
+
+#if defined(__AVX__)
+    template class BVHNReorder<8>;
+#endif
+    template class BVHNReorder<4>;
+  }
+}
@@ -0,0 +1,44 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /* Reorders the nodes and leaves of a BVH into a single memory block. The
+     * nodes are clustered into treelets of about the size of a memory page,
+     * each treelet greedily grows into the children of largest surface
+     * area, and the leaves of a node are stored directly behind the node. */
+    template<int N>
+    class BVHNReorder
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AABBNode AABBNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+    public:
+
+      /*! number of bytes of nodes and leaves clustered into one treelet */
+      static const size_t treeletBytes = 4096;
+
+      /*! nodes are aligned to cache lines */
+      static const size_t nodeAlignment = 64;
+
+    public:
+
+      /*! reorders the BVH after a build of a static scene if enabled for the device */
+      static __forceinline void reorderStatic(BVH* bvh)
+      {
+        if (bvh->device->bvh_reorder && bvh->scene && bvh->scene->isStaticAccel())
+          reorder(bvh);
+      }
+
+      /*! reorders the BVH, returns false and keeps the BVH unmodified if it contains unsupported nodes */
+      static bool reorder(BVH* bvh);
+    };
+  }
+}
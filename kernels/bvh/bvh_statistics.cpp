@@ -25,6 +25,10 @@ namespace embree
     stream << "#bytes = " << std::setw(7) << std::setprecision(2) << totalBytes/1E6 << " MB (100.00%), ";
     stream << "#nodes = " << std::setw(7) << stat.size() << " (" << std::setw(6) << std::setprecision(2) << 100.0*stat.fillRate(bvh) << "% filled), ";
     stream << "#bytes/prim = " << std::setw(6) << std::setprecision(2) << double(totalBytes)/double(bvh->numPrimitives) << std::endl;
+    stream << "  traversal        : cost = " << std::setw(7) << std::setprecision(3) << traversalCost() << ", ";
+    stream << "#node fetches = " << std::setw(7) << std::setprecision(3) << nodeFetches() << ", ";
+    stream << "#leaf fetches = " << std::setw(7) << std::setprecision(3) << leafFetches() << ", ";
+    stream << "cost/node fetch = " << std::setw(7) << std::setprecision(3) << traversalCost()/max(nodeFetches(),1.0) << std::endl;
     if (stat.statAABBNodes.numNodes    ) stream << "  getAABBNodes     : "  << stat.statAABBNodes.toString(bvh,totalSAH,totalBytes) << std::endl;
     if (stat.statOBBNodes.numNodes  ) stream << "  ungetAABBNodes   : "  << stat.statOBBNodes.toString(bvh,totalSAH,totalBytes) << std::endl;
     if (stat.statAABBNodesMB.numNodes  ) stream << "  getAABBNodesMB   : "  << stat.statAABBNodesMB.toString(bvh,totalSAH,totalBytes) << std::endl;
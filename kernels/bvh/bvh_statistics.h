@@ -272,6 +272,29 @@ namespace embree
       return stat.bytes(bvh);
     }
 
+    size_t bytesLeaves() const {
+      return stat.statLeaf.bytes(bvh);
+    }
+
+    size_t bytesNodes() const {
+      return stat.bytes(bvh)-stat.statLeaf.bytes(bvh);
+    }
+
+    /*! expected number of inner nodes a ray traverses */
+    double nodeFetches() const {
+      return stat.sah(bvh)-stat.statLeaf.sah(bvh);
+    }
+
+    /*! expected number of primitive blocks a ray intersects */
+    double leafFetches() const {
+      return stat.statLeaf.sah(bvh);
+    }
+
+    /*! expected traversal cost of a ray for the given cost of a traversal step and of a primitive block intersection */
+    double traversalCost(float travCost = 1.0f, float intCost = 1.0f) const {
+      return travCost*nodeFetches() + intCost*leafFetches();
+    }
+
   private:
     Statistics statistics(NodeRef node, const double A, const BBox1f dt);
 
@@ -839,6 +839,145 @@ namespace embree
       }
     };
 
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Point query of K points against one node child
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    template<int K>
+    __forceinline vfloat<K> pointQuerySphereDistK(const Vec3vf<K>& p,
+                                                  const vfloat<K>& lower_x, const vfloat<K>& upper_x,
+                                                  const vfloat<K>& lower_y, const vfloat<K>& upper_y,
+                                                  const vfloat<K>& lower_z, const vfloat<K>& upper_z)
+    {
+      const vfloat<K> vX = min(max(p.x, lower_x), upper_x) - p.x;
+      const vfloat<K> vY = min(max(p.y, lower_y), upper_y) - p.y;
+      const vfloat<K> vZ = min(max(p.z, lower_z), upper_z) - p.z;
+      return vX * vX + vY * vY + vZ * vZ;
+    }
+
+    template<int N, int K>
+    __forceinline vbool<K> pointQueryNodeSphereK(const typename BVHN<N>::AABBNode* node, size_t i,
+                                                 const Vec3vf<K>& p, const vfloat<K>& radius2, vfloat<K>& dist)
+    {
+      if (unlikely(node->lower_x[i] > node->upper_x[i])) return false;
+      dist = pointQuerySphereDistK<K>(p,
+                                      vfloat<K>(node->lower_x[i]), vfloat<K>(node->upper_x[i]),
+                                      vfloat<K>(node->lower_y[i]), vfloat<K>(node->upper_y[i]),
+                                      vfloat<K>(node->lower_z[i]), vfloat<K>(node->upper_z[i]));
+      return dist <= radius2;
+    }
+
+    template<int N, int K>
+    __forceinline vbool<K> pointQueryNodeSphereK(const typename BVHN<N>::AABBNodeMB* node, size_t i,
+                                                 const Vec3vf<K>& p, const vfloat<K>& time, const vfloat<K>& radius2, vfloat<K>& dist)
+    {
+      const vfloat<K> vlower_x = madd(time, vfloat<K>(node->lower_dx[i]), vfloat<K>(node->lower_x[i]));
+      const vfloat<K> vlower_y = madd(time, vfloat<K>(node->lower_dy[i]), vfloat<K>(node->lower_y[i]));
+      const vfloat<K> vlower_z = madd(time, vfloat<K>(node->lower_dz[i]), vfloat<K>(node->lower_z[i]));
+      const vfloat<K> vupper_x = madd(time, vfloat<K>(node->upper_dx[i]), vfloat<K>(node->upper_x[i]));
+      const vfloat<K> vupper_y = madd(time, vfloat<K>(node->upper_dy[i]), vfloat<K>(node->upper_y[i]));
+      const vfloat<K> vupper_z = madd(time, vfloat<K>(node->upper_dz[i]), vfloat<K>(node->upper_z[i]));
+      dist = pointQuerySphereDistK<K>(p, vlower_x, vupper_x, vlower_y, vupper_y, vlower_z, vupper_z);
+      return (dist <= radius2) & (vlower_x <= vupper_x);
+    }
+
+    template<int N, int K>
+    __forceinline vbool<K> pointQueryNodeSphereKMB4D(const typename BVHN<N>::NodeRef ref, size_t i,
+                                                     const Vec3vf<K>& p, const vfloat<K>& time, const vfloat<K>& radius2, vfloat<K>& dist)
+    {
+      const typename BVHN<N>::AABBNodeMB* node = ref.getAABBNodeMB();
+      vbool<K> vmask = pointQueryNodeSphereK<N,K>(node, i, p, time, radius2, dist);
+
+      if (unlikely(ref.isAABBNodeMB4D())) {
+        const typename BVHN<N>::AABBNodeMB4D* node1 = (const typename BVHN<N>::AABBNodeMB4D*) node;
+        vmask &= (node1->lower_t[i] <= time) & (time < node1->upper_t[i]);
+      }
+      return vmask;
+    }
+
+    template<int N, int K>
+    __forceinline vbool<K> pointQueryNodeSphereK(const typename BVHN<N>::QuantizedNode* node, size_t i,
+                                                 const Vec3vf<K>& p, const vfloat<K>& radius2, vfloat<K>& dist)
+    {
+      if (unlikely(!(movemask(node->validMask()) & ((size_t)1 << i)))) return false;
+      const vfloat<N> lower_x = node->dequantizeLowerX();
+      const vfloat<N> upper_x = node->dequantizeUpperX();
+      const vfloat<N> lower_y = node->dequantizeLowerY();
+      const vfloat<N> upper_y = node->dequantizeUpperY();
+      const vfloat<N> lower_z = node->dequantizeLowerZ();
+      const vfloat<N> upper_z = node->dequantizeUpperZ();
+      dist = pointQuerySphereDistK<K>(p,
+                                      vfloat<K>(lower_x[i]), vfloat<K>(upper_x[i]),
+                                      vfloat<K>(lower_y[i]), vfloat<K>(upper_y[i]),
+                                      vfloat<K>(lower_z[i]), vfloat<K>(upper_z[i]));
+      return dist <= radius2;
+    }
 
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Node intersectors used in packet point query traversal
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    /*! Computes squared distances of K point queries to the children of N nodes, types
+     *  without specialization are traversed with single point queries */
+    template<int N, int K, int types>
+    struct BVHNNodePointQuerySphereK
+    {
+      static const bool enabled = false;
+
+      static __forceinline bool pointQuery(const typename BVHN<N>::NodeRef& node, size_t i, const Vec3vf<K>& p, const vfloat<K>& time,
+                                           const vfloat<K>& radius2, vfloat<K>& dist, vbool<K>& vmask) { return false; }
+    };
+
+    template<int N, int K>
+    struct BVHNNodePointQuerySphereK<N, K, BVH_AN1>
+    {
+      static const bool enabled = true;
+
+      static __forceinline bool pointQuery(const typename BVHN<N>::NodeRef& node, size_t i, const Vec3vf<K>& p, const vfloat<K>& time,
+                                           const vfloat<K>& radius2, vfloat<K>& dist, vbool<K>& vmask)
+      {
+        vmask &= pointQueryNodeSphereK<N,K>(node.getAABBNode(), i, p, radius2, dist);
+        return true;
+      }
+    };
+
+    template<int N, int K>
+    struct BVHNNodePointQuerySphereK<N, K, BVH_AN2>
+    {
+      static const bool enabled = true;
+
+      static __forceinline bool pointQuery(const typename BVHN<N>::NodeRef& node, size_t i, const Vec3vf<K>& p, const vfloat<K>& time,
+                                           const vfloat<K>& radius2, vfloat<K>& dist, vbool<K>& vmask)
+      {
+        vmask &= pointQueryNodeSphereK<N,K>(node.getAABBNodeMB(), i, p, time, radius2, dist);
+        return true;
+      }
+    };
+
+    template<int N, int K>
+    struct BVHNNodePointQuerySphereK<N, K, BVH_AN2_AN4D>
+    {
+      static const bool enabled = true;
+
+      static __forceinline bool pointQuery(const typename BVHN<N>::NodeRef& node, size_t i, const Vec3vf<K>& p, const vfloat<K>& time,
+                                           const vfloat<K>& radius2, vfloat<K>& dist, vbool<K>& vmask)
+      {
+        vmask &= pointQueryNodeSphereKMB4D<N,K>(node, i, p, time, radius2, dist);
+        return true;
+      }
+    };
+
+    template<int N, int K>
+    struct BVHNNodePointQuerySphereK<N, K, BVH_QN1>
+    {
+      static const bool enabled = true;
+
+      static __forceinline bool pointQuery(const typename BVHN<N>::NodeRef& node, size_t i, const Vec3vf<K>& p, const vfloat<K>& time,
+                                           const vfloat<K>& radius2, vfloat<K>& dist, vbool<K>& vmask)
+      {
+        vmask &= pointQueryNodeSphereK<N,K>((const typename BVHN<N>::QuantizedNode*)node.quantizedNode(), i, p, radius2, dist);
+        return true;
+      }
+    };
   }
 }
@@ -29,6 +29,15 @@ namespace embree
     /*! clears the acceleration structure data */
     virtual void clear() = 0;
 
+    /*! stores the acceleration structure data into a stream, returns false if not supported */
+    virtual bool save(std::ostream& stream) { return false; }
+
+    /*! restores the acceleration structure data from a stream, returns false if the stream does not match */
+    virtual bool load(std::istream& stream) { return false; }
+
+    /*! adds the memory consumption of the acceleration structure to the statistics */
+    virtual void getMemoryStatistics(RTCSceneMemoryStatistics& stat) {}
+
     /*! returns normal bounds */
     __forceinline BBox3fa getBounds() const {
       return bounds.bounds();
@@ -63,13 +72,19 @@ namespace embree
     struct Intersectors;
 
     /*! Type of collide function */
-    typedef void (*CollideFunc)(void* bvh0, void* bvh1, RTCCollideFunc callback, void* userPtr);
+    typedef void (*CollideFunc)(void* bvh0, void* bvh1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args);
 
     /*! Type of point query function */
     typedef bool(*PointQueryFunc)(Intersectors* This,          /*!< this pointer to accel */
                                   PointQuery* query,        /*!< point query for lookup */
                                   PointQueryContext* context); /*!< point query context */
 
+    /*! Type of point query function for a packet of point queries. */
+    typedef bool(*PointQueryFuncN)(Intersectors* This,          /*!< this pointer to accel */
+                                   PointQuery** queries,        /*!< point queries for lookup, nullptr for inactive queries */
+                                   PointQueryContext** contexts, /*!< point query context of each query */
+                                   size_t N);                   /*!< number of point queries */
+
     /*! Type of intersect function pointer for single rays. */
     typedef void (*IntersectFunc)(Intersectors* This,  /*!< this pointer to accel */
                                   RTCRayHit& ray,      /*!< ray to intersect */
@@ -136,13 +151,16 @@ namespace embree
     struct Intersector1
     {
       Intersector1 (ErrorFunc error = nullptr)
-      : intersect((IntersectFunc)error), occluded((OccludedFunc)error), name(nullptr) {}
+      : intersect((IntersectFunc)error), occluded((OccludedFunc)error), pointQueryN((PointQueryFuncN)error), name(nullptr) {}
       
       Intersector1 (IntersectFunc intersect, OccludedFunc occluded, const char* name)
-      : intersect(intersect), occluded(occluded), pointQuery(nullptr), name(name) {}
+      : intersect(intersect), occluded(occluded), pointQuery(nullptr), pointQueryN(nullptr), name(name) {}
       
       Intersector1 (IntersectFunc intersect, OccludedFunc occluded, PointQueryFunc pointQuery, const char* name)
-      : intersect(intersect), occluded(occluded), pointQuery(pointQuery), name(name) {}
+      : intersect(intersect), occluded(occluded), pointQuery(pointQuery), pointQueryN(nullptr), name(name) {}
+
+      Intersector1 (IntersectFunc intersect, OccludedFunc occluded, PointQueryFunc pointQuery, PointQueryFuncN pointQueryN, const char* name)
+      : intersect(intersect), occluded(occluded), pointQuery(pointQuery), pointQueryN(pointQueryN), name(name) {}
 
       operator bool() const { return name; }
 
@@ -151,6 +169,7 @@ namespace embree
       IntersectFunc intersect;
       OccludedFunc occluded;
       PointQueryFunc pointQuery;
+      PointQueryFuncN pointQueryN;
       const char* name;
     };
     
@@ -258,10 +277,22 @@ namespace embree
         return intersector1.pointQuery(this,query,context);
       }
 
+      /*! performs a packet of N point queries, falls back to single point queries if no packet traversal is available */
+      __forceinline bool pointQueryN (PointQuery** queries, PointQueryContext** contexts, size_t N)
+      {
+        if (likely(intersector1.pointQueryN))
+          return intersector1.pointQueryN(this,queries,contexts,N);
+
+        bool changed = false;
+        for (size_t i=0; i<N; i++)
+          if (queries[i]) changed |= pointQuery(queries[i],contexts[i]);
+        return changed;
+      }
+
       /*! collides two scenes */
-      __forceinline void collide (Accel* scene0, Accel* scene1, RTCCollideFunc callback, void* userPtr) {
+      __forceinline void collide (Accel* scene0, Accel* scene1, RTCCollideFunc callback, void* userPtr, const RTCCollideArguments* args) {
         assert(collider.collide);
-        collider.collide(scene0->intersectors.ptr,scene1->intersectors.ptr,callback,userPtr);
+        collider.collide(scene0->intersectors.ptr,scene1->intersectors.ptr,callback,userPtr,args);
       }
 
       /*! Intersects a single ray with the scene. */
@@ -448,6 +479,7 @@ namespace embree
     return Accel::Intersector1((Accel::IntersectFunc )intersector::intersect, \
                                (Accel::OccludedFunc  )intersector::occluded,  \
                                (Accel::PointQueryFunc)intersector::pointQuery,\
+                               (Accel::PointQueryFuncN)intersector::pointQueryN,\
                                TOSTRING(isa) "::" TOSTRING(symbol));          \
   }
   
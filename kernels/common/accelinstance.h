@@ -34,6 +34,21 @@ namespace embree
       if (builder) builder->clear();
     }
 
+    bool save(std::ostream& stream) {
+      return accel && accel->save(stream);
+    }
+
+    bool load(std::istream& stream)
+    {
+      if (!accel || !accel->load(stream)) return false;
+      bounds = accel->bounds;
+      return true;
+    }
+
+    void getMemoryStatistics(RTCSceneMemoryStatistics& stat) {
+      if (accel) accel->getMemoryStatistics(stat);
+    }
+
   private:
     std::unique_ptr<AccelData> accel;
     std::unique_ptr<Builder> builder;
@@ -20,6 +20,7 @@ namespace embree
 
   public:
     static bool pointQuery (Accel::Intersectors* This, PointQuery* query, PointQueryContext* context);
+    static bool pointQueryN (Accel::Intersectors* This, PointQuery** queries, PointQueryContext** contexts, size_t N);
 
   public:
     static void intersect (Accel::Intersectors* This, RTCRayHit& ray, RayQueryContext* context);
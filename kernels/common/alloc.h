@@ -29,6 +29,8 @@ namespace embree
 
     static const size_t MAX_THREAD_USED_BLOCK_SLOTS = 8;
 
+    struct Block;
+
   public:
 
     struct ThreadLocal2;
@@ -195,9 +197,16 @@ namespace embree
       , maxGrowSize(maxAllocationSize)
       , usedBlocks(nullptr)
       , freeBlocks(nullptr)
+      , retiredBlocks(nullptr)
       , useUSM(useUSM)
       , blockAllocation(blockAllocation)
       , use_single_mode(false)
+      , numa(false)
+      , numaSlotsPerNode(1)
+      , budget(nullptr)
+      , bytesBudgeted(0)
+      , retainBlocks(false)
+      , doubleBuffer(false)
       , log2_grow_size_scale(0)
       , bytesUsed(0)
       , bytesFree(0)
@@ -214,10 +223,19 @@ namespace embree
         threadBlocks[i] = nullptr;
         assert(!slotMutex[i].isLocked());
       }
+
+      /* in NUMA mode the block slots get partitioned among the NUMA nodes */
+      const size_t numNodes = getNumberOfNumaNodes();
+      if (device && device->numa && numNodes > 1)
+      {
+        numa = true;
+        while (2*numaSlotsPerNode*numNodes <= MAX_THREAD_USED_BLOCK_SLOTS)
+          numaSlotsPerNode *= 2;
+      }
     }
 
     ~FastAllocator () {
-      clear();
+      clear_blocks();
     }
 
     /*! returns the device attached to this allocator */
@@ -245,6 +263,22 @@ namespace embree
       atype = flag ? EMBREE_OS_MALLOC : ALIGNED_MALLOC;
     }
 
+    /*! all blocks of the allocator get additionally reported to this memory budget */
+    void setMemoryBudget(MemoryMonitorInterface* budget_i) {
+      budget = budget_i;
+    }
+
+    /*! when retaining blocks, clear() only resets the allocator such
+     *  that rebuilds re-carve the blocks of previous builds. In double
+     *  buffer mode the blocks of the previous build are additionally
+     *  not reused before the next build, thus the previous BVH stays
+     *  intact while a new one gets built. */
+    void setBlockRetention(bool retain, bool doubleBuffer_i)
+    {
+      retainBlocks = retain || doubleBuffer_i;
+      doubleBuffer = doubleBuffer_i;
+    }
+
   private:
 
     /*! returns both fast thread local allocators */
@@ -430,9 +464,18 @@ namespace embree
       internal_fix_used_blocks();
       /* distribute the allocation to multiple thread block slots */
       slotMask = MAX_THREAD_USED_BLOCK_SLOTS-1; // FIXME: remove
-      if (usedBlocks.load() || freeBlocks.load()) { reset(); return; }
       if (bytesReserve == 0) bytesReserve = bytesAllocate;
-      freeBlocks = Block::create(device,useUSM,bytesAllocate,bytesReserve,nullptr,atype);
+      if (usedBlocks.load() || freeBlocks.load() || retiredBlocks.load())
+      {
+        reset();
+
+        /* the first free block has to hold bytesAllocate bytes, retained blocks of smaller builds may not */
+        Block* first = freeBlocks.load();
+        if (first == nullptr || first->getBlockAllocatedBytes() < bytesAllocate)
+          freeBlocks = createBlock(bytesAllocate,bytesReserve,first);
+        return;
+      }
+      freeBlocks = createBlock(bytesAllocate,bytesReserve,nullptr);
       estimatedSize = bytesEstimate;
       initGrowSizeAndNumSlots(bytesEstimate,true);
     }
@@ -441,7 +484,7 @@ namespace embree
     void init_estimate(size_t bytesEstimate)
     {
       internal_fix_used_blocks();
-      if (usedBlocks.load() || freeBlocks.load()) { reset(); return; }
+      if (usedBlocks.load() || freeBlocks.load() || retiredBlocks.load()) { reset(); return; }
       /* single allocator mode ? */
       estimatedSize = bytesEstimate;
       //initGrowSizeAndNumSlots(bytesEstimate,false);
@@ -468,6 +511,13 @@ namespace embree
       bytesFree.store(0);
       bytesWasted.store(0);
 
+      /* in double buffer mode the used blocks get retired and the blocks retired by the previous reset get reused */
+      if (doubleBuffer && usedBlocks.load() != nullptr) {
+        Block* retired = retiredBlocks.load();
+        retiredBlocks = usedBlocks.load();
+        usedBlocks = retired;
+      }
+
       /* reset all used blocks and move them to begin of free block list */
       while (usedBlocks.load() != nullptr) {
         usedBlocks.load()->reset_block();
@@ -491,15 +541,28 @@ namespace embree
       thread_local_allocators.clear();
     }
 
-    /*! frees all allocated memory */
+    /*! frees all allocated memory, or only resets the allocator when blocks get retained */
     __forceinline void clear()
+    {
+      if (retainBlocks) {
+        reset();
+        primrefarray.clear();
+        return;
+      }
+      clear_blocks();
+    }
+
+    /*! frees all allocated memory including retained blocks */
+    void clear_blocks()
     {
       cleanup();
       bytesUsed.store(0);
       bytesFree.store(0);
       bytesWasted.store(0);
+      if (budget && bytesBudgeted.load()) budget->memoryMonitor(-ssize_t(bytesBudgeted.exchange(0)),true);
       if (usedBlocks.load() != nullptr) usedBlocks.load()->clear_list(device,useUSM); usedBlocks = nullptr;
       if (freeBlocks.load() != nullptr) freeBlocks.load()->clear_list(device,useUSM); freeBlocks = nullptr;
+      if (retiredBlocks.load() != nullptr) retiredBlocks.load()->clear_list(device,useUSM); retiredBlocks = nullptr;
       for (size_t i=0; i<MAX_THREAD_USED_BLOCK_SLOTS; i++) {
         threadUsedBlocks[i] = nullptr;
         threadBlocks[i] = nullptr;
@@ -507,6 +570,23 @@ namespace embree
       primrefarray.clear();
     }
 
+    /*! returns the block slot to use for some thread running on some NUMA node */
+    __forceinline size_t getSlot(size_t threadID, unsigned int node) const
+    {
+      if (!numa) return threadID & slotMask;
+      return (node*numaSlotsPerNode + (threadID & slotMask & (numaSlotsPerNode-1))) & (MAX_THREAD_USED_BLOCK_SLOTS-1);
+    }
+
+    /*! creates a new block, its reserved bytes get charged to the memory budget first */
+    Block* createBlock(size_t bytesAllocate, size_t bytesReserve, Block* next)
+    {
+      if (budget) {
+        budget->memoryMonitor(bytesReserve,false);
+        bytesBudgeted += bytesReserve;
+      }
+      return Block::create(device,useUSM,bytesAllocate,bytesReserve,next,atype);
+    }
+
     __forceinline size_t incGrowSizeScale()
     {
       size_t scale = log2_grow_size_scale.fetch_add(1)+1;
@@ -522,7 +602,8 @@ namespace embree
       {
         /* allocate using current block */
         size_t threadID = TaskScheduler::threadID();
-        size_t slot = threadID & slotMask;
+        const unsigned int node = numa ? getNumaNode() : 0;
+        size_t slot = getSlot(threadID,node);
         Block* myUsedBlocks = threadUsedBlocks[slot];
         if (myUsedBlocks) {
           void* ptr = myUsedBlocks->malloc(device,bytes,align,partial);
@@ -547,7 +628,9 @@ namespace embree
             const size_t alignedBytes = (bytes+(align-1)) & ~(align-1);
             const size_t allocSize = max(min(growSize,maxGrowSize),alignedBytes);
             assert(allocSize >= bytes);
-            threadBlocks[slot] = threadUsedBlocks[slot] = Block::create(device,useUSM,allocSize,allocSize,threadBlocks[slot],atype); // FIXME: a large allocation might throw away a block here!
+            Block* block = createBlock(allocSize,allocSize,threadBlocks[slot]); // FIXME: a large allocation might throw away a block here!
+            if (numa) block->bind_numa(node);
+            threadBlocks[slot] = threadUsedBlocks[slot] = block;
             // FIXME: a direct allocation should allocate inside the block here, and not in the next loop! a different thread could do some allocation and make the large allocation fail.
           }
           continue;
@@ -571,8 +654,9 @@ namespace embree
               freeBlocks = nextFreeBlock;
             } else {
               const size_t allocSize = min(growSize*incGrowSizeScale(),maxGrowSize);
-              usedBlocks = threadUsedBlocks[slot] = Block::create(device,useUSM,allocSize,allocSize,usedBlocks,atype); // FIXME: a large allocation should get delivered directly, like above!
+              usedBlocks = threadUsedBlocks[slot] = createBlock(allocSize,allocSize,usedBlocks); // FIXME: a large allocation should get delivered directly, like above!
             }
+            if (numa) threadUsedBlocks[slot].load()->bind_numa(node);
           }
         }
       }
@@ -586,6 +670,7 @@ namespace embree
 #else
       Lock<SpinLock> lock(mutex);
 #endif
+      if (doubleBuffer) return; // shared blocks get reused by the next build and cannot be retired
       const size_t sizeof_Header = offsetof(Block,data[0]);
       void* aptr = (void*) ((((size_t)ptr)+maxAlignment-1) & ~(maxAlignment-1));
       size_t ofs = (size_t) aptr - (size_t) ptr;
@@ -601,6 +686,32 @@ namespace embree
       return freeBlocks.load()->ptr();
     }
 
+    /*! calls the closure with pointer and size of the used memory of each used block */
+    template<typename Closure>
+    void iterateUsedBlocks(const Closure& closure)
+    {
+      internal_fix_used_blocks();
+      for (Block* block = usedBlocks.load(); block; block = block->next) {
+        const size_t bytes = block->getBlockUsedBytes();
+        if (bytes) closure((const char*)&block->data[0],bytes);
+      }
+    }
+
+    /*! allocates a new block of some size that is entirely marked as used, used when restoring stored data structures */
+    void* mallocBlock(size_t bytes)
+    {
+#if defined(APPLE) && defined(__aarch64__)
+      std::scoped_lock lock(mutex);
+#else
+      Lock<SpinLock> lock(mutex);
+#endif
+      bytes = (bytes+maxAlignment-1) & ~(maxAlignment-1);
+      Block* block = createBlock(bytes,bytes,usedBlocks);
+      usedBlocks = block;
+      bytesUsed += bytes;
+      return block->malloc(device,bytes,maxAlignment,false);
+    }
+
     struct Statistics
     {
       Statistics ()
@@ -614,10 +725,13 @@ namespace embree
       {
         Block* usedBlocks = alloc->usedBlocks.load();
         Block* freeBlocks = alloc->freeBlocks.load();
+        Block* retiredBlocks = alloc->retiredBlocks.load();
         if (usedBlocks) bytesUsed += usedBlocks->getUsedBytes(atype,huge_pages);
         if (freeBlocks) bytesFree += freeBlocks->getAllocatedBytes(atype,huge_pages);
+        if (retiredBlocks) bytesFree += retiredBlocks->getAllocatedBytes(atype,huge_pages);
         if (usedBlocks) bytesFree += usedBlocks->getFreeBytes(atype,huge_pages);
         if (freeBlocks) bytesWasted += freeBlocks->getWastedBytes(atype,huge_pages);
+        if (retiredBlocks) bytesWasted += retiredBlocks->getWastedBytes(atype,huge_pages);
         if (usedBlocks) bytesWasted += usedBlocks->getWastedBytes(atype,huge_pages);
       }
 
@@ -902,6 +1016,13 @@ namespace embree
         return &data[cur];
       }
 
+      /*! migrates the pages of the block to some NUMA node, shared blocks are owned by someone else and stay untouched */
+      void bind_numa(unsigned int node)
+      {
+        if (atype == SHARED) return;
+        os_bind_numa(&data[0],getBlockReservedBytes(),node);
+      }
+
       void reset_block ()
       {
         allocEnd = max(allocEnd,(size_t)cur);
@@ -1023,10 +1144,17 @@ namespace embree
     std::atomic<Block*> threadBlocks[MAX_THREAD_USED_BLOCK_SLOTS];
     std::atomic<Block*> usedBlocks;
     std::atomic<Block*> freeBlocks;
+    std::atomic<Block*> retiredBlocks;   //!< blocks of the previous build in double buffer mode
 
     bool useUSM;
     bool blockAllocation = true;
     bool use_single_mode;
+    bool numa;                  //!< places blocks on the NUMA node of the allocating thread
+    size_t numaSlotsPerNode;    //!< number of block slots per NUMA node in NUMA mode
+    MemoryMonitorInterface* budget;     //!< optional memory budget all blocks get reported to
+    std::atomic<size_t> bytesBudgeted;  //!< bytes reported to the memory budget
+    bool retainBlocks;          //!< clear() keeps the blocks for the next build
+    bool doubleBuffer;          //!< blocks of the previous build are kept intact during the next build
 
     std::atomic<size_t> log2_grow_size_scale; //!< log2 of scaling factor for grow size // FIXME: remove
     std::atomic<size_t> bytesUsed;
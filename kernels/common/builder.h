@@ -9,6 +9,7 @@
 namespace embree
 {  
 #define MODE_HIGH_QUALITY (1<<8)
+#define MODE_COLLAPSE (1<<9)        //!< build a binary BVH and collapse it optimally to the BVH width
 
   /*! virtual interface for all hierarchy builders */
   class Builder : public RefCount {
@@ -16,7 +16,7 @@ namespace embree
   public:
 
     __forceinline RayQueryContext(Scene* scene, RTCRayQueryContext* user_context, RTCIntersectArguments* args)
-      : scene(scene), user(user_context), args(args) {}
+      : scene(scene), user(user_context), args(args), multiHit(args->multiHit) {}
 
     __forceinline RayQueryContext(Scene* scene, RTCRayQueryContext* user_context, RTCOccludedArguments* args)
       : scene(scene), user(user_context), args((RTCIntersectArguments*)args) {}
@@ -25,6 +25,15 @@ namespace embree
       return args->filter != nullptr;
     }
 
+    /*! occlusion queries never collect multiple hits, as RTCOccludedArguments has no multi-hit buffer */
+    __forceinline bool hasMultiHit() const {
+      return multiHit != nullptr;
+    }
+
+    __forceinline RTCMultiHit* getMultiHit() const {
+      return multiHit;
+    }
+
     RTCFilterFunctionN getFilter() const {
       return args->filter;
     }
@@ -59,6 +68,7 @@ namespace embree
     Scene* scene = nullptr;
     RTCRayQueryContext* user = nullptr;
     RTCIntersectArguments* args = nullptr;
+    RTCMultiHit* multiHit = nullptr;
   };
 
   template<int M, typename Geometry>
@@ -36,8 +36,11 @@ namespace embree
   ssize_t Device::debug_int2 = 0;
   ssize_t Device::debug_int3 = 0;
 
+  DECLARE_SYMBOL2(RayStreamFilterFuncs,rayStreamFilterFuncs);
+
   static MutexSys g_mutex;
   static std::map<Device*,size_t> g_cache_size_map;
+  static std::map<Device*,size_t> g_cache_max_size_map;
   static std::map<Device*,size_t> g_num_threads_map;
   
   struct TaskArena
@@ -103,7 +106,7 @@ namespace embree
     State::hugepages_success &= os_init(State::hugepages,State::verbosity(3));
     
     /*! set tessellation cache size */
-    setCacheSize( State::tessellation_cache_size );
+    setCacheSize( State::tessellation_cache_size, State::tessellation_cache_max_size );
 
     /*! enable some floating point exceptions to catch bugs */
     if (State::float_exceptions)
@@ -131,6 +134,12 @@ namespace embree
     bvh8_factory = make_unique(new BVH8Factory(enabled_builder_cpu_features, enabled_cpu_features));
 #endif
 
+#if defined(EMBREE_RAY_PACKETS)
+    RayStreamFilterFuncsType rayStreamFilterFuncs;
+    SELECT_SYMBOL_DEFAULT_SSE42_AVX_AVX2_AVX512(enabled_cpu_features,rayStreamFilterFuncs);
+    rayStreamFilters = rayStreamFilterFuncs();
+#endif
+
     /* setup tasking system */
     initTaskingSystem(numThreads);
   }
@@ -333,23 +342,25 @@ namespace embree
     return maxNumThreads;
   }
 
-  size_t getMaxCacheSize()
+  size_t getMaxCacheSize(const std::map<Device*,size_t>& cache_size_map)
   {
     size_t maxCacheSize = 0;
-    for (std::map<Device*,size_t>::iterator i=g_cache_size_map.begin(); i!= g_cache_size_map.end(); i++)
+    for (std::map<Device*,size_t>::const_iterator i=cache_size_map.begin(); i!= cache_size_map.end(); i++)
       maxCacheSize = max(maxCacheSize, (*i).second);
     return maxCacheSize;
   }
  
-  void Device::setCacheSize(size_t bytes) 
+  void Device::setCacheSize(size_t bytes, size_t maxBytes) 
   {
 #if defined(EMBREE_GEOMETRY_SUBDIVISION)
     Lock<MutexSys> lock(g_mutex);
     if (bytes == 0) g_cache_size_map.erase(this);
     else            g_cache_size_map[this] = bytes;
+    if (bytes == 0 || maxBytes == 0) g_cache_max_size_map.erase(this);
+    else                             g_cache_max_size_map[this] = maxBytes;
     
-    size_t maxCacheSize = getMaxCacheSize();
-    resizeTessellationCache(maxCacheSize);
+    size_t maxCacheSize = getMaxCacheSize(g_cache_size_map);
+    resizeTessellationCache(maxCacheSize,getMaxCacheSize(g_cache_max_size_map));
 #endif
   }
 
@@ -547,6 +558,26 @@ namespace embree
     case RTC_DEVICE_PROPERTY_POINT_GEOMETRY_SUPPORTED: return 0;
 #endif
 
+#if defined(EMBREE_GEOMETRY_SUBDIVISION)
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_SIZE: return SharedLazyTessellationCache::sharedLazyTessellationCache.getSize();
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS: {
+      size_t hits = 0, misses = 0;
+      SharedLazyTessellationCache::sharedLazyTessellationCache.getStats(hits,misses);
+      return hits;
+    }
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES: {
+      size_t hits = 0, misses = 0;
+      SharedLazyTessellationCache::sharedLazyTessellationCache.getStats(hits,misses);
+      return misses;
+    }
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_FLUSHES: return SharedTessellationCacheStats::cache_flushes;
+#else
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_SIZE: return 0;
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS: return 0;
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES: return 0;
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_FLUSHES: return 0;
+#endif
+
 #if defined(TASKING_PPL)
     case RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED: return 0;
 #elif defined(TASKING_TBB) && (TBB_INTERFACE_VERSION_MAJOR < 8)
@@ -6,6 +6,7 @@
 #include "default.h"
 #include "state.h"
 #include "accel.h"
+#include "../bvh/bvh_intersector_stream_filters.h"
 
 namespace embree
 {
@@ -92,8 +93,8 @@ namespace embree
     /*! invokes the memory monitor callback */
     void memoryMonitor(ssize_t bytes, bool post);
 
-    /*! sets the size of the software cache. */
-    void setCacheSize(size_t bytes);
+    /*! sets the size of the software cache and the size it may grow to. */
+    void setCacheSize(size_t bytes, size_t maxBytes = 0);
 
     /*! sets a property */
     void setProperty(const RTCDeviceProperty prop, ssize_t val);
@@ -140,6 +141,10 @@ namespace embree
 #if defined(EMBREE_TARGET_SIMD8)
     std::unique_ptr<BVH8Factory> bvh8_factory;
 #endif
+
+#if defined(EMBREE_RAY_PACKETS)
+    RayStreamFilterFuncs rayStreamFilters;
+#endif
   };
 
 #if defined(EMBREE_SYCL_SUPPORT)
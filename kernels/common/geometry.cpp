@@ -32,7 +32,7 @@ namespace embree
     "quads",
     "grid",
     "subdivs",
-    "",
+    "instance_array",
     "sphere",
     "disc",
     "oriented_disc",
@@ -97,11 +97,27 @@ namespace embree
   void Geometry::update()
   {
     ++modCounter_; // FIXME: required?
+    modifiedPrims_ = range<unsigned int>(0,-1);
     state = (unsigned)State::MODIFIED;
   }
+
+  void Geometry::updateBufferPrimitiveRange(RTCBufferType type, unsigned int slot, unsigned int primBegin, unsigned int primCount)
+  {
+    if (primBegin > size() || primCount > size()-primBegin)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid primitive range");
+
+    updateBuffer(type,slot);
+    if (primCount == 0) return;
+    modifiedPrims_ = range<unsigned int>(min(modifiedPrims_.begin(),primBegin),max(modifiedPrims_.end(),primBegin+primCount));
+  }
   
   void Geometry::commit() 
   {
+    /* a commit without any primitive range update modifies all primitives */
+    committedModCounter_ = modCounter_;
+    committedModifiedPrims_ = modifiedPrims_.empty() ? range<unsigned int>(0,-1) : modifiedPrims_;
+    modifiedPrims_ = range<unsigned int>(-1,0);
+
     ++modCounter_;
     state = (unsigned)State::COMMITTED;
   }
@@ -26,13 +26,14 @@ namespace embree
         numUserGeometries(0), numMBUserGeometries(0), 
         numInstancesCheap(0), numMBInstancesCheap(0), 
         numInstancesExpensive(0), numMBInstancesExpensive(0), 
+        numInstanceArrays(0), numMBInstanceArrays(0), 
         numGrids(0), numMBGrids(0),
         numSubGrids(0), numMBSubGrids(0), 
         numPoints(0), numMBPoints(0) {}
 
     __forceinline size_t size() const {
-      return    numTriangles + numQuads + numBezierCurves + numLineSegments + numSubdivPatches + numUserGeometries + numInstancesCheap + numInstancesExpensive + numGrids + numPoints
-              + numMBTriangles + numMBQuads + numMBBezierCurves + numMBLineSegments + numMBSubdivPatches + numMBUserGeometries + numMBInstancesCheap + numMBInstancesExpensive + numMBGrids + numMBPoints;
+      return    numTriangles + numQuads + numBezierCurves + numLineSegments + numSubdivPatches + numUserGeometries + numInstancesCheap + numInstancesExpensive + numInstanceArrays + numGrids + numPoints
+              + numMBTriangles + numMBQuads + numMBBezierCurves + numMBLineSegments + numMBSubdivPatches + numMBUserGeometries + numMBInstancesCheap + numMBInstancesExpensive + numMBInstanceArrays + numMBGrids + numMBPoints;
     }
 
     __forceinline unsigned int enabledGeometryTypesMask() const
@@ -47,6 +48,7 @@ namespace embree
       if (numInstancesExpensive) mask |= 1 << 6;
       if (numGrids) mask |= 1 << 7;
       if (numPoints) mask |= 1 << 8;
+      if (numInstanceArrays) mask |= 1 << 9;
 
       unsigned int maskMB = 0;
       if (numMBTriangles) maskMB |= 1 << 0;
@@ -58,8 +60,9 @@ namespace embree
       if (numMBInstancesExpensive) maskMB |= 1 << 6;
       if (numMBGrids) maskMB |= 1 << 7;
       if (numMBPoints) maskMB |= 1 << 8;
+      if (numMBInstanceArrays) maskMB |= 1 << 9;
       
-      return (mask<<8) + maskMB;
+      return (mask<<16) + maskMB;
     }
 
     __forceinline GeometryCounts operator+ (GeometryCounts const & rhs) const
@@ -82,6 +85,8 @@ namespace embree
       ret.numMBInstancesCheap = numMBInstancesCheap + rhs.numMBInstancesCheap;
       ret.numInstancesExpensive = numInstancesExpensive + rhs.numInstancesExpensive;
       ret.numMBInstancesExpensive = numMBInstancesExpensive + rhs.numMBInstancesExpensive;
+      ret.numInstanceArrays = numInstanceArrays + rhs.numInstanceArrays;
+      ret.numMBInstanceArrays = numMBInstanceArrays + rhs.numMBInstanceArrays;
       ret.numGrids = numGrids + rhs.numGrids;
       ret.numMBGrids = numMBGrids + rhs.numMBGrids;
       ret.numSubGrids = numSubGrids + rhs.numSubGrids;
@@ -109,6 +114,8 @@ namespace embree
     size_t numMBInstancesCheap;      //!< number of enabled motion blurred cheap instances
     size_t numInstancesExpensive;    //!< number of enabled expensive instances
     size_t numMBInstancesExpensive;  //!< number of enabled motion blurred expensive instances
+    size_t numInstanceArrays;        //!< number of enabled instance arrays
+    size_t numMBInstanceArrays;      //!< number of enabled motion blurred instance arrays
     size_t numGrids;                 //!< number of enabled grid geometries
     size_t numMBGrids;               //!< number of enabled motion blurred grid geometries
     size_t numSubGrids;              //!< number of enabled grid geometries
@@ -153,6 +160,7 @@ namespace embree
       GTY_QUAD_MESH = 21,
       GTY_GRID_MESH = 22,
       GTY_SUBDIV_MESH = 23,
+      GTY_INSTANCE_ARRAY = 24,
 
       GTY_SPHERE_POINT = 25,
       GTY_DISC_POINT = 26,
@@ -230,6 +238,7 @@ namespace embree
       MTY_INSTANCE_CHEAP = 1ul << GTY_INSTANCE_CHEAP,
       MTY_INSTANCE_EXPENSIVE = 1ul << GTY_INSTANCE_EXPENSIVE,
       MTY_INSTANCE = MTY_INSTANCE_CHEAP | MTY_INSTANCE_EXPENSIVE,
+      MTY_INSTANCE_ARRAY = 1ul << GTY_INSTANCE_ARRAY,
 
       MTY_ALL = -1
     };
@@ -353,6 +362,9 @@ namespace embree
     virtual void updateBuffer(RTCBufferType type, unsigned int slot) {
       update(); // update everything for geometries not supporting this call
     }
+
+    /*! Update geometry buffer for a range of primitives only. */
+    void updateBufferPrimitiveRange(RTCBufferType type, unsigned int slot, unsigned int primBegin, unsigned int primCount);
     
     /*! Disable geometry. */
     virtual void disable();
@@ -444,6 +456,15 @@ namespace embree
       return modCounter_;
     }
 
+    /*! Returns the range of primitives modified by the last commit, if no other modification happened since the specified modification counter */
+    __forceinline bool getModifiedPrimitives (unsigned int modCounter, range<unsigned int>& prims) const
+    {
+      if (modCounter != committedModCounter_)
+        return false;
+      prims = committedModifiedPrims_;
+      return true;
+    }
+
     /*! for triangle meshes and bezier curves only */
   public:
 
@@ -482,6 +503,11 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry");
     }
 
+    /*! Sets the instanced scenes of an instance array */
+    virtual void setInstancedScenes(const RTCScene* scenes, size_t numScenes) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry");
+    }
+
     /*! Sets transformation of the instance */
     virtual void setTransform(const AffineSpace3fa& transform, unsigned int timeStep) {
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
@@ -497,6 +523,13 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Returns the transformation of the instPrimID'th instance of an instance array */
+    virtual AffineSpace3fa getTransform(size_t instPrimID, float time) {
+      if (instPrimID != 0)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid instance primitive ID");
+      return getTransform(time);
+    }
+
     /*! for user geometries only */
   public:
 
@@ -626,6 +659,9 @@ namespace embree
     
     unsigned int mask;             //!< for masking out geometry
     unsigned int modCounter_ = 1; //!< counter for every modification - used to rebuild scenes when geo is modified
+    unsigned int committedModCounter_ = 0;                                        //!< modification counter before the last commit
+    range<unsigned int> modifiedPrims_ = range<unsigned int>(-1,0);              //!< primitives modified since the last commit
+    range<unsigned int> committedModifiedPrims_ = range<unsigned int>(0,-1);     //!< primitives modified by the last commit
 
     struct {
       GType gtype : 8;                //!< geometry type
@@ -20,10 +20,11 @@ namespace embree
     __forceinline HitK(const RTCRayQueryContext* context, const vuint<K>& geomID, const vuint<K>& primID, const vfloat<K>& u, const vfloat<K>& v, const Vec3vf<K>& Ng)
       : Ng(Ng), u(u), v(v), primID(primID), geomID(geomID) 
     {
-      for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
-        instID[l] = RTC_INVALID_GEOMETRY_ID;
-      
-      instance_id_stack::copy_UV<K>(context->instID, instID);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      instance_id_stack::copy_UV<K>(context, instID, instPrimID);
+#else
+      instance_id_stack::copy_UV<K>(context, instID);
+#endif
     }
 
     /* Constructs a hit */
@@ -40,6 +41,9 @@ namespace embree
     vuint<K> primID;      // primitive ID
     vuint<K> geomID;      // geometry ID
     vuint<K> instID[RTC_MAX_INSTANCE_LEVEL_COUNT];      // instance ID
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    vuint<K> instPrimID[RTC_MAX_INSTANCE_LEVEL_COUNT];  // instance primitive ID
+#endif
   };
 
   /* Specialization for a single hit */
@@ -53,7 +57,11 @@ namespace embree
     __forceinline HitK(const RTCRayQueryContext* context, unsigned int geomID, unsigned int primID, float u, float v, const Vec3fa& Ng)
       : Ng(Ng.x,Ng.y,Ng.z), u(u), v(v), primID(primID), geomID(geomID)
     {
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      instance_id_stack::copy_UU(context, instID, instPrimID);
+#else
       instance_id_stack::copy_UU(context, instID);
+#endif
     }
 
     /* Constructs a hit */
@@ -70,6 +78,9 @@ namespace embree
     unsigned int primID;      // primitive ID
     unsigned int geomID;      // geometry ID
     unsigned int instID[RTC_MAX_INSTANCE_LEVEL_COUNT];      // instance ID
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    unsigned int instPrimID[RTC_MAX_INSTANCE_LEVEL_COUNT];  // instance primitive ID
+#endif
   };
 
   /* Shortcuts */
@@ -94,6 +105,13 @@ namespace embree
     {
       cout << " " << ray.instID[l];
     }
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    cout << embree_endl << "  instPrimID =";
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+    {
+      cout << " " << ray.instPrimID[l];
+    }
+#endif
     cout << embree_endl;
     return cout << "}";
   }
@@ -106,7 +124,11 @@ namespace embree
     ray.v    = hit.v;
     ray.primID = hit.primID;
     ray.geomID = hit.geomID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    instance_id_stack::copy_UU(hit.instID, hit.instPrimID, ray.instID, ray.instPrimID);
+#else
     instance_id_stack::copy_UU(hit.instID, ray.instID);
+#endif
   }
 
   template<int K>
@@ -119,6 +141,10 @@ namespace embree
     vfloat<K>::storeu(mask,&ray.v, hit.v);
     vuint<K>::storeu(mask,&ray.primID, hit.primID);
     vuint<K>::storeu(mask,&ray.geomID, hit.geomID);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    instance_id_stack::copy_VV<K>(hit.instID, hit.instPrimID, ray.instID, ray.instPrimID, mask);
+#else
     instance_id_stack::copy_VV<K>(hit.instID, ray.instID, mask);
+#endif
   }
 }
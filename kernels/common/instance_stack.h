@@ -21,21 +21,31 @@ static_assert(RTC_MAX_INSTANCE_LEVEL_COUNT > 0,
  */
 template<typename Context>
 RTC_FORCEINLINE bool push(Context context, 
-                          unsigned instanceId)
+                          unsigned instanceId,
+                          unsigned instancePrimId = 0)
 {
 #if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
   const bool spaceAvailable = context->instStackSize < RTC_MAX_INSTANCE_LEVEL_COUNT;
   /* We assert here because instances are silently dropped when the stack is full. 
      This might be quite hard to find in production. */
   assert(spaceAvailable); 
-  if (likely(spaceAvailable))
-    context->instID[context->instStackSize++] = instanceId;
+  if (likely(spaceAvailable)) {
+    context->instID[context->instStackSize] = instanceId;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    context->instPrimID[context->instStackSize] = instancePrimId;
+#endif
+    context->instStackSize++;
+  }
   return spaceAvailable;
 #else
   const bool spaceAvailable = (context->instID[0] == RTC_INVALID_GEOMETRY_ID);
   assert(spaceAvailable); 
-  if (likely(spaceAvailable))
+  if (likely(spaceAvailable)) {
     context->instID[0] = instanceId;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    context->instPrimID[0] = instancePrimId;
+#endif
+  }
   return spaceAvailable;
 #endif
 }
@@ -50,10 +60,17 @@ RTC_FORCEINLINE void pop(Context context)
   assert(context);
 #if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
   assert(context->instStackSize > 0);
-  context->instID[--context->instStackSize] = RTC_INVALID_GEOMETRY_ID;
+  --context->instStackSize;
+  context->instID[context->instStackSize] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  context->instPrimID[context->instStackSize] = RTC_INVALID_GEOMETRY_ID;
+#endif
 #else
   assert(context->instID[0] != RTC_INVALID_GEOMETRY_ID);
   context->instID[0] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  context->instPrimID[0] = RTC_INVALID_GEOMETRY_ID;
+#endif
 #endif
 }
 
@@ -61,6 +78,7 @@ RTC_FORCEINLINE void pop(Context context)
 /* Push an instance to the stack. Used for point queries*/
 RTC_FORCEINLINE bool push(RTCPointQueryContext* context,
                           unsigned int instanceId,
+                          unsigned int instancePrimId,
                           AffineSpace3fa const& w2i,
                           AffineSpace3fa const& i2w)
 {
@@ -68,6 +86,9 @@ RTC_FORCEINLINE bool push(RTCPointQueryContext* context,
   const size_t stackSize = context->instStackSize;
   assert(stackSize < RTC_MAX_INSTANCE_LEVEL_COUNT);
   context->instID[stackSize] = instanceId;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  context->instPrimID[stackSize] = instancePrimId;
+#endif
 
   AffineSpace3fa_store_unaligned(w2i,(AffineSpace3fa*)context->world2inst[stackSize]);
   AffineSpace3fa_store_unaligned(i2w,(AffineSpace3fa*)context->inst2world[stackSize]);
@@ -96,14 +117,20 @@ RTC_FORCEINLINE void pop(RTCPointQueryContext* context)
 #else
   assert(context->instID[0] != RTC_INVALID_GEOMETRY_ID);
 #endif
-  context->instID[--context->instStackSize] = RTC_INVALID_GEOMETRY_ID;
+  --context->instStackSize;
+  context->instID[context->instStackSize] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  context->instPrimID[context->instStackSize] = RTC_INVALID_GEOMETRY_ID;
+#endif
 }
 
 /*
  * Optimized instance id stack copy.
- * The copy() functions will either copy full
- * stacks or copy only until the last valid element has been copied, depending
- * on RTC_MAX_INSTANCE_LEVEL_COUNT.
+ * The copy() functions copy the stack up to and including the first
+ * invalid element, as all readers stop at this terminator. Elements
+ * behind the terminator are left untouched. The overloads taking two
+ * source and target arrays copy the instance primitive ID stack of
+ * instance arrays alongside, terminated by the instance ID stack.
  */
 RTC_FORCEINLINE void copy_UU(const unsigned* src, unsigned* tgt)
 {
@@ -113,49 +140,117 @@ RTC_FORCEINLINE void copy_UU(const unsigned* src, unsigned* tgt)
 #else
   for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
     tgt[l] = src[l];
-    if (RTC_MAX_INSTANCE_LEVEL_COUNT > 4)
-      if (src[l] == RTC_INVALID_GEOMETRY_ID)
-        break;
+    if (src[l] == RTC_INVALID_GEOMETRY_ID)
+      break;
   }
 #endif
 }
 
-RTC_FORCEINLINE void copy_UU(const RTCRayQueryContext* context, unsigned* tgt)
+RTC_FORCEINLINE void copy_UU(const unsigned* src, const unsigned* srcPrim, unsigned* tgt, unsigned* tgtPrim)
 {
-  const unsigned* src = context->instID;
-
 #if (RTC_MAX_INSTANCE_LEVEL_COUNT == 1)
   tgt[0] = src[0];
+  tgtPrim[0] = srcPrim[0];
   
 #else
-  
-  unsigned int depth = context->instStackSize;
-  
-  for (unsigned l = 0; l < depth; ++l)
+  for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
     tgt[l] = src[l];
-  
-  for (unsigned l = depth; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
-    tgt[l] = RTC_INVALID_GEOMETRY_ID;
+    tgtPrim[l] = srcPrim[l];
+    if (src[l] == RTC_INVALID_GEOMETRY_ID)
+      break;
+  }
+#endif
+}
 
+RTC_FORCEINLINE unsigned instPrimID(const RTCRayQueryContext* context, unsigned l)
+{
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  return context->instPrimID[l];
+#else
+  return 0;
 #endif
 }
-  
-template <int K>
-RTC_FORCEINLINE void copy_UV(const unsigned* src, vuint<K>* tgt)
+
+/*
+ * Copies the instance id stack of a query context using its current
+ * depth. Flat and single level instanced scenes take dedicated paths,
+ * thus shallow scenes do not pay for a large RTC_MAX_INSTANCE_LEVEL_COUNT.
+ * The store functor receives the level, the instance ID and the
+ * instance primitive ID (0 if instance arrays are disabled).
+ */
+template<typename Store>
+RTC_FORCEINLINE void copy_context(const RTCRayQueryContext* context, const Store& store)
 {
 #if (RTC_MAX_INSTANCE_LEVEL_COUNT == 1)
-  tgt[0] = src[0];
+  store(0, context->instID[0], instPrimID(context, 0));
 
 #else
-  for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
-    tgt[l] = src[l];
-    if (RTC_MAX_INSTANCE_LEVEL_COUNT > 4)
-      if (src[l] == RTC_INVALID_GEOMETRY_ID)
-        break;
+  const unsigned depth = context->instStackSize;
+  if (likely(depth == 0)) {
+    store(0, RTC_INVALID_GEOMETRY_ID, RTC_INVALID_GEOMETRY_ID);
+  }
+  else if (likely(depth == 1)) {
+    store(0, context->instID[0], instPrimID(context, 0));
+    store(1, RTC_INVALID_GEOMETRY_ID, RTC_INVALID_GEOMETRY_ID);
+  }
+  else {
+    for (unsigned l = 0; l < depth; ++l)
+      store(l, context->instID[l], instPrimID(context, l));
+    if (depth < RTC_MAX_INSTANCE_LEVEL_COUNT)
+      store(depth, RTC_INVALID_GEOMETRY_ID, RTC_INVALID_GEOMETRY_ID);
   }
 #endif
 }
 
+RTC_FORCEINLINE void copy_UU(const RTCRayQueryContext* context, unsigned* tgt)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned) { tgt[l] = id; });
+}
+
+RTC_FORCEINLINE void copy_UU(const RTCRayQueryContext* context, unsigned* tgt, unsigned* tgtPrim)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned primID) { tgt[l] = id; tgtPrim[l] = primID; });
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_UV(const RTCRayQueryContext* context, vuint<K>* tgt)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned) { tgt[l] = id; });
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_UV(const RTCRayQueryContext* context, vuint<K>* tgt, vuint<K>* tgtPrim)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned primID) { tgt[l] = id; tgtPrim[l] = primID; });
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_UV(const RTCRayQueryContext* context, vuint<K>* tgt, size_t j)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned) { tgt[l][j] = id; });
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_UV(const RTCRayQueryContext* context, vuint<K>* tgt, vuint<K>* tgtPrim, size_t j)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned primID) { tgt[l][j] = id; tgtPrim[l][j] = primID; });
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_UV(const RTCRayQueryContext* context, vuint<K>* tgt, const vbool<K>& mask)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned) { vuint<K>::store(mask, tgt + l, id); });
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_UV(const RTCRayQueryContext* context, vuint<K>* tgt, vuint<K>* tgtPrim, const vbool<K>& mask)
+{
+  copy_context(context, [&] (unsigned l, unsigned id, unsigned primID) {
+    vuint<K>::store(mask, tgt + l, id);
+    vuint<K>::store(mask, tgtPrim + l, primID);
+  });
+}
+
 template <int K>
 RTC_FORCEINLINE void copy_UV(const unsigned* src, vuint<K>* tgt, size_t j)
 {
@@ -165,25 +260,25 @@ RTC_FORCEINLINE void copy_UV(const unsigned* src, vuint<K>* tgt, size_t j)
 #else
   for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
     tgt[l][j] = src[l];
-    if (RTC_MAX_INSTANCE_LEVEL_COUNT > 4)
-      if (src[l] == RTC_INVALID_GEOMETRY_ID)
-        break;
+    if (src[l] == RTC_INVALID_GEOMETRY_ID)
+      break;
   }
 #endif
 }
 
 template <int K>
-RTC_FORCEINLINE void copy_UV(const unsigned* src, vuint<K>* tgt, const vbool<K>& mask)
+RTC_FORCEINLINE void copy_UV(const unsigned* src, const unsigned* srcPrim, vuint<K>* tgt, vuint<K>* tgtPrim, size_t j)
 {
 #if (RTC_MAX_INSTANCE_LEVEL_COUNT == 1)
-  vuint<K>::store(mask, tgt, src[0]);
+  tgt[0][j] = src[0];
+  tgtPrim[0][j] = srcPrim[0];
 
 #else
   for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
-    vuint<K>::store(mask, tgt + l, src[l]);
-    if (RTC_MAX_INSTANCE_LEVEL_COUNT > 4)
-      if (src[l] == RTC_INVALID_GEOMETRY_ID)
-        break;
+    tgt[l][j] = src[l];
+    tgtPrim[l][j] = srcPrim[l];
+    if (src[l] == RTC_INVALID_GEOMETRY_ID)
+      break;
   }
 #endif
 }
@@ -197,9 +292,25 @@ RTC_FORCEINLINE void copy_VU(const vuint<K>* src, unsigned* tgt, size_t i)
 #else
   for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
     tgt[l] = src[l][i];
-    if (RTC_MAX_INSTANCE_LEVEL_COUNT > 4)
-      if (src[l][i] == RTC_INVALID_GEOMETRY_ID)
-        break;
+    if (src[l][i] == RTC_INVALID_GEOMETRY_ID)
+      break;
+  }
+#endif
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_VU(const vuint<K>* src, const vuint<K>* srcPrim, unsigned* tgt, unsigned* tgtPrim, size_t i)
+{
+#if (RTC_MAX_INSTANCE_LEVEL_COUNT == 1)
+  tgt[0] = src[0][i];
+  tgtPrim[0] = srcPrim[0][i];
+
+#else
+  for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
+    tgt[l] = src[l][i];
+    tgtPrim[l] = srcPrim[l][i];
+    if (src[l][i] == RTC_INVALID_GEOMETRY_ID)
+      break;
   }
 #endif
 }
@@ -213,9 +324,25 @@ RTC_FORCEINLINE void copy_VV(const vuint<K>* src, vuint<K>* tgt, size_t i, size_
 #else
   for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
     tgt[l][j] = src[l][i];
-    if (RTC_MAX_INSTANCE_LEVEL_COUNT > 4)
-      if (src[l][i] == RTC_INVALID_GEOMETRY_ID)
-        break;
+    if (src[l][i] == RTC_INVALID_GEOMETRY_ID)
+      break;
+  }
+#endif
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_VV(const vuint<K>* src, const vuint<K>* srcPrim, vuint<K>* tgt, vuint<K>* tgtPrim, size_t i, size_t j)
+{
+#if (RTC_MAX_INSTANCE_LEVEL_COUNT == 1)
+  tgt[0][j] = src[0][i];
+  tgtPrim[0][j] = srcPrim[0][i];
+
+#else
+  for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
+    tgt[l][j] = src[l][i];
+    tgtPrim[l][j] = srcPrim[l][i];
+    if (src[l][i] == RTC_INVALID_GEOMETRY_ID)
+      break;
   }
 #endif
 }
@@ -229,11 +356,27 @@ RTC_FORCEINLINE void copy_VV(const vuint<K>* src, vuint<K>* tgt, const vbool<K>&
 #else
   vbool<K> done = !mask;
   for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
-    vuint<K>::store(mask, tgt + l, src[l]);
-    if (RTC_MAX_INSTANCE_LEVEL_COUNT > 4) {
-      done |= src[l] == RTC_INVALID_GEOMETRY_ID;
-      if (all(done)) break;
-    }
+    vuint<K>::store(mask & !done, tgt + l, src[l]);
+    done |= src[l] == RTC_INVALID_GEOMETRY_ID;
+    if (all(done)) break;
+  }
+#endif
+}
+
+template <int K>
+RTC_FORCEINLINE void copy_VV(const vuint<K>* src, const vuint<K>* srcPrim, vuint<K>* tgt, vuint<K>* tgtPrim, const vbool<K>& mask)
+{
+#if (RTC_MAX_INSTANCE_LEVEL_COUNT == 1)
+  vuint<K>::store(mask, tgt, src[0]);
+  vuint<K>::store(mask, tgtPrim, srcPrim[0]);
+
+#else
+  vbool<K> done = !mask;
+  for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
+    vuint<K>::store(mask & !done, tgt + l, src[l]);
+    vuint<K>::store(mask & !done, tgtPrim + l, srcPrim[l]);
+    done |= src[l] == RTC_INVALID_GEOMETRY_ID;
+    if (all(done)) break;
   }
 #endif
 }
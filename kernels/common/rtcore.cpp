@@ -322,6 +322,102 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API RTCSceneCommit rtcCommitSceneAsync (RTCScene hscene, RTCSceneCommitFunction func, void* userPtr)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcCommitSceneAsync);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_ENTER_DEVICE(hscene);
+    SceneCommit* commit = new SceneCommit(scene,func,userPtr);
+    commit->refInc();
+    return (RTCSceneCommit) commit;
+    RTC_CATCH_END2(scene);
+    return nullptr;
+  }
+
+  RTC_API bool rtcIsSceneCommitDone (RTCSceneCommit hcommit)
+  {
+    SceneCommit* commit = (SceneCommit*) hcommit;
+    Scene* scene = commit ? commit->getScene() : nullptr;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIsSceneCommitDone);
+    RTC_VERIFY_HANDLE(hcommit);
+    return commit->isDone();
+    RTC_CATCH_END2(scene);
+    return false;
+  }
+
+  RTC_API RTCError rtcWaitSceneCommit (RTCSceneCommit hcommit)
+  {
+    SceneCommit* commit = (SceneCommit*) hcommit;
+    Scene* scene = commit ? commit->getScene() : nullptr;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcWaitSceneCommit);
+    RTC_VERIFY_HANDLE(hcommit);
+    return commit->wait();
+    RTC_CATCH_END2(scene);
+    return RTC_ERROR_UNKNOWN;
+  }
+
+  RTC_API void rtcCancelSceneCommit (RTCSceneCommit hcommit)
+  {
+    SceneCommit* commit = (SceneCommit*) hcommit;
+    Scene* scene = commit ? commit->getScene() : nullptr;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcCancelSceneCommit);
+    RTC_VERIFY_HANDLE(hcommit);
+    commit->cancel();
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcRetainSceneCommit (RTCSceneCommit hcommit)
+  {
+    SceneCommit* commit = (SceneCommit*) hcommit;
+    Scene* scene = commit ? commit->getScene() : nullptr;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcRetainSceneCommit);
+    RTC_VERIFY_HANDLE(hcommit);
+    commit->refInc();
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcReleaseSceneCommit (RTCSceneCommit hcommit)
+  {
+    SceneCommit* commit = (SceneCommit*) hcommit;
+    Scene* scene = commit ? commit->getScene() : nullptr;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcReleaseSceneCommit);
+    RTC_VERIFY_HANDLE(hcommit);
+    commit->refDec();
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcSaveSceneBVH (RTCScene hscene, const char* filename)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSaveSceneBVH);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_VERIFY_HANDLE(filename);
+    RTC_ENTER_DEVICE(hscene);
+    scene->saveBVH(filename);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API bool rtcLoadSceneBVH (RTCScene hscene, const char* filename)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcLoadSceneBVH);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_VERIFY_HANDLE(filename);
+    RTC_ENTER_DEVICE(hscene);
+    return scene->loadBVH(filename);
+    RTC_CATCH_END2(scene);
+    return false;
+  }
+
   RTC_API void rtcGetSceneBounds(RTCScene hscene, RTCBounds* bounds_o)
   {
     Scene* scene = (Scene*) hscene;
@@ -373,7 +469,32 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
-  RTC_API void rtcCollide (RTCScene hscene0, RTCScene hscene1, RTCCollideFunc callback, void* userPtr)
+  RTC_API void rtcSetSceneMemoryBudget(RTCScene hscene, size_t bytes)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetSceneMemoryBudget);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_ENTER_DEVICE(hscene);
+    scene->setMemoryBudget(bytes);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API size_t rtcGetSceneMemoryStatistics(RTCScene hscene, RTCSceneMemoryStatistics* stats, size_t maxStats)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetSceneMemoryStatistics);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_ENTER_DEVICE(hscene);
+    if (stats == nullptr && maxStats != 0)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid destination pointer");
+    return scene->getMemoryStatistics(stats,maxStats);
+    RTC_CATCH_END2(scene);
+    return 0;
+  }
+
+  RTC_API void rtcCollide (RTCScene hscene0, RTCScene hscene1, RTCCollideFunc callback, void* userPtr, RTCCollideArguments* args)
   {
     Scene* scene0 = (Scene*) hscene0;
     Scene* scene1 = (Scene*) hscene1;
@@ -385,11 +506,15 @@ RTC_NAMESPACE_BEGIN;
     if (scene0->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
     if (scene1->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
     if (scene0->device != scene1->device) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes are from different devices");
-    auto nUserPrims0 = scene0->getNumPrimitives (Geometry::MTY_USER_GEOMETRY, false);
-    auto nUserPrims1 = scene1->getNumPrimitives (Geometry::MTY_USER_GEOMETRY, false);
-    if (scene0->numPrimitives() != nUserPrims0 && scene1->numPrimitives() != nUserPrims1) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes must only contain user geometries with a single timestep");
 #endif
-    scene0->intersectors.collide(scene0,scene1,callback,userPtr);
+    if (!scene0->intersectors.collider.collide || scene0->intersectors.collider.collide != scene1->intersectors.collider.collide)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes must either only contain user geometries, or only triangles, or only quads with a single timestep");
+    RTCCollideArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitCollideArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    scene0->intersectors.collide(scene0,scene1,callback,userPtr,args);
     RTC_CATCH_END(scene0->device);
   }
   
@@ -423,6 +548,49 @@ RTC_NAMESPACE_BEGIN;
     return changed;
   }
 
+  template<int K>
+  inline bool pointQueryK(const int* valid, Scene* scene, PointQueryK<K>* queryK, RTCPointQueryContext* userContext, RTCPointQueryFunction queryFunc, void** userPtrN)
+  {
+    bool changed = false;
+
+    /* queries inside instances get transformed individually */
+    if (userContext->instStackSize > 0)
+    {
+      PointQuery query1;
+      for (size_t i=0; i<K; i++) {
+        if (!valid[i]) continue;
+        queryK->get(i,query1);
+        changed |= pointQuery(scene, (RTCPointQuery*)&query1, userContext, queryFunc, userPtrN?userPtrN[i]:NULL);
+        queryK->set(i,query1);
+      }
+      return changed;
+    }
+
+    /* all other queries get traversed together as packet */
+    PointQuery query1[K];
+    PointQuery* queries[K];
+    PointQueryContext* contexts[K];
+    typename std::aligned_storage<sizeof(PointQueryContext),alignof(PointQueryContext)>::type context1[K];
+
+    for (size_t i=0; i<K; i++)
+    {
+      queries[i] = nullptr;
+      contexts[i] = nullptr;
+      if (!valid[i]) continue;
+      queryK->get(i,query1[i]);
+      queries[i] = &query1[i];
+      contexts[i] = new (&context1[i]) PointQueryContext(scene, &query1[i], POINT_QUERY_TYPE_SPHERE, queryFunc, userContext, 1.f, userPtrN?userPtrN[i]:NULL);
+    }
+
+    changed = scene->intersectors.pointQueryN(queries, contexts, K);
+
+    for (size_t i=0; i<K; i++) {
+      if (!valid[i]) continue;
+      queryK->set(i,query1[i]);
+    }
+    return changed;
+  }
+
   RTC_API bool rtcPointQuery(RTCScene hscene, RTCPointQuery* query, RTCPointQueryContext* userContext, RTCPointQueryFunction queryFunc, void* userPtr)
   {
     Scene* scene = (Scene*) hscene;
@@ -455,16 +623,7 @@ RTC_NAMESPACE_BEGIN;
     STAT(size_t cnt=0; for (size_t i=0; i<4; i++) cnt += ((int*)valid)[i] == -1;);
     STAT3(point_query.travs,cnt,cnt,cnt);
 
-    bool changed = false;
-    PointQuery4* query4 = (PointQuery4*)query;
-    PointQuery query1; 
-    for (size_t i=0; i<4; i++) {
-      if (!valid[i]) continue;
-      query4->get(i,query1);
-      changed |= pointQuery(scene, (RTCPointQuery*)&query1, userContext, queryFunc, userPtrN?userPtrN[i]:NULL);
-      query4->set(i,query1);
-    }
-    return changed;
+    return pointQueryK<4>(valid, scene, (PointQuery4*)query, userContext, queryFunc, userPtrN);
     RTC_CATCH_END2_FALSE(scene);
   }
   
@@ -480,19 +639,10 @@ RTC_NAMESPACE_BEGIN;
     if (((size_t)valid) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "mask not aligned to 16 bytes");   
     if (((size_t)query) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "query not aligned to 16 bytes");   
 #endif
-    STAT(size_t cnt=0; for (size_t i=0; i<4; i++) cnt += ((int*)valid)[i] == -1;);
+    STAT(size_t cnt=0; for (size_t i=0; i<8; i++) cnt += ((int*)valid)[i] == -1;);
     STAT3(point_query.travs,cnt,cnt,cnt);
 
-    bool changed = false;
-    PointQuery8* query8 = (PointQuery8*)query;
-    PointQuery query1; 
-    for (size_t i=0; i<8; i++) {
-      if (!valid[i]) continue;
-      query8->get(i,query1);
-      changed |= pointQuery(scene, (RTCPointQuery*)&query1, userContext, queryFunc, userPtrN?userPtrN[i]:NULL);
-      query8->set(i,query1);
-    }
-    return changed;
+    return pointQueryK<8>(valid, scene, (PointQuery8*)query, userContext, queryFunc, userPtrN);
     RTC_CATCH_END2_FALSE(scene);
   }
 
@@ -508,19 +658,10 @@ RTC_NAMESPACE_BEGIN;
     if (((size_t)valid) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "mask not aligned to 16 bytes");   
     if (((size_t)query) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "query not aligned to 16 bytes");   
 #endif
-    STAT(size_t cnt=0; for (size_t i=0; i<4; i++) cnt += ((int*)valid)[i] == -1;);
+    STAT(size_t cnt=0; for (size_t i=0; i<16; i++) cnt += ((int*)valid)[i] == -1;);
     STAT3(point_query.travs,cnt,cnt,cnt);
 
-    bool changed = false;
-    PointQuery16* query16 = (PointQuery16*)query;
-    PointQuery query1; 
-    for (size_t i=0; i<16; i++) {
-      if (!valid[i]) continue;
-      PointQuery query1; query16->get(i,query1);
-      changed |= pointQuery(scene, (RTCPointQuery*)&query1, userContext, queryFunc, userPtrN?userPtrN[i]:NULL);
-      query16->set(i,query1);
-    }
-    return changed;
+    return pointQueryK<16>(valid, scene, (PointQuery16*)query, userContext, queryFunc, userPtrN);
     RTC_CATCH_END2_FALSE(scene);
   }
 
@@ -549,8 +690,28 @@ RTC_NAMESPACE_BEGIN;
       user_context = &defaultContext;
     }
     RayQueryContext context(scene,user_context,args);
+
+    /* multi-hit queries collect hits through the filter path of the traversal */
+    RTCMultiHit* multiHit = context.getMultiHit();
+    if (unlikely(multiHit))
+    {
+      if (multiHit->maxHits == 0 || multiHit->t == nullptr || multiHit->hits == nullptr)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid multi-hit buffer");
+#if !defined(EMBREE_FILTER_FUNCTION)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"multi-hit queries require EMBREE_FILTER_FUNCTION");
+#endif
+      if (!scene->hasArgumentFilterFunction())
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"multi-hit queries require RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS");
+      multiHit->numHits = 0;
+    }
     
     scene->intersectors.intersect(*rayhit,&context);
+
+    /* report the closest collected hit through the ray */
+    if (unlikely(multiHit) && multiHit->numHits && multiHit->t[0] <= rayhit->ray.tfar) {
+      rayhit->ray.tfar = multiHit->t[0];
+      rayhit->hit = multiHit->hits[0];
+    }
 #if defined(DEBUG)
     ((RayHit*)rayhit)->verifyHit();
 #endif
@@ -610,6 +771,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitIntersectArguments(&defaultArgs);
       args = &defaultArgs;
     }
+    if (unlikely(args->multiHit)) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"multi-hit queries are only supported for single rays");
     RTCRayQueryContext* user_context = args->context;
     
     RTCRayQueryContext defaultContext;
@@ -731,6 +893,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitIntersectArguments(&defaultArgs);
       args = &defaultArgs;
     }
+    if (unlikely(args->multiHit)) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"multi-hit queries are only supported for single rays");
     RTCRayQueryContext* user_context = args->context;
     
     RTCRayQueryContext defaultContext;
@@ -786,6 +949,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitIntersectArguments(&defaultArgs);
       args = &defaultArgs;
     }
+    if (unlikely(args->multiHit)) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"multi-hit queries are only supported for single rays");
     RTCRayQueryContext* user_context = args->context;
     
     RTCRayQueryContext defaultContext;
@@ -811,6 +975,81 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcIntersect1M (RTCScene hscene, RTCRayHit* rayhit, unsigned int M, size_t byteStride, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersect1M);
+
+#if defined(EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)rayhit) & 0x03) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 4 bytes");   
+#endif
+    STAT3(normal.travs,M,M,M);
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    if (unlikely(args->multiHit)) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"multi-hit queries are only supported for single rays");
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    RayQueryContext context(scene,user_context,args);
+
+    scene->device->rayStreamFilters.intersectAOS(scene,rayhit,M,byteStride,&context);
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcIntersect1M not supported");
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcIntersectNp (RTCScene hscene, const RTCRayHitNp* rayhit, unsigned int N, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectNp);
+
+#if defined(EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)rayhit->ray.org_x ) & 0x03 ) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit->ray.org_x not aligned to 4 bytes");
+    if (((size_t)rayhit->ray.dir_x ) & 0x03 ) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit->ray.dir_x not aligned to 4 bytes");
+    if (((size_t)rayhit->ray.tfar  ) & 0x03 ) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit->ray.tfar not aligned to 4 bytes");
+    if (((size_t)rayhit->hit.geomID) & 0x03 ) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit->hit.geomID not aligned to 4 bytes");
+#endif
+    STAT3(normal.travs,N,N,N);
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    if (unlikely(args->multiHit)) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"multi-hit queries are only supported for single rays");
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    RayQueryContext context(scene,user_context,args);
+
+    scene->device->rayStreamFilters.intersectSOP(scene,*rayhit,N,&context);
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcIntersectNp not supported");
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcForwardIntersect16 (const int* valid, const RTCIntersectFunctionNArguments* args, RTCScene hscene, RTCRay16* iray, unsigned int instID)
   {
     Scene* scene = (Scene*) hscene;
@@ -1082,6 +1321,78 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcOccluded1M (RTCScene hscene, RTCRay* ray, unsigned int M, size_t byteStride, RTCOccludedArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccluded1M);
+
+#if defined(EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)ray) & 0x03) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 4 bytes");   
+#endif
+    STAT3(shadow.travs,M,M,M);
+
+    RTCOccludedArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitOccludedArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    RayQueryContext context(scene,user_context,args);
+
+    scene->device->rayStreamFilters.occludedAOS(scene,ray,M,byteStride,&context);
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcOccluded1M not supported");
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcOccludedNp (RTCScene hscene, const RTCRayNp* ray, unsigned int N, RTCOccludedArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccludedNp);
+
+#if defined(EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)ray->org_x) & 0x03 ) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "org_x not aligned to 4 bytes");
+    if (((size_t)ray->dir_x) & 0x03 ) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "dir_x not aligned to 4 bytes");
+    if (((size_t)ray->tfar ) & 0x03 ) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "tfar not aligned to 4 bytes");
+#endif
+    STAT3(shadow.travs,N,N,N);
+
+    RTCOccludedArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitOccludedArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    RayQueryContext context(scene,user_context,args);
+
+    scene->device->rayStreamFilters.occludedSOP(scene,*ray,N,&context);
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcOccludedNp not supported");
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcForwardOccluded16 (const int* valid, const RTCOccludedFunctionNArguments* args, RTCScene hscene, RTCRay16* iray, unsigned int instID)
   {
     Scene* scene = (Scene*) hscene;
@@ -1126,6 +1437,17 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryInstancedScenes(RTCGeometry hgeometry, RTCScene* scenes, size_t numScenes)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryInstancedScenes);
+    RTC_VERIFY_HANDLE(hgeometry);
+    RTC_ENTER_DEVICE(hgeometry);
+    geometry->setInstancedScenes(scenes,numScenes);
+    RTC_CATCH_END2(geometry);
+  }
+
   AffineSpace3fa loadTransform(RTCFormat format, const float* xfm)
   {
     AffineSpace3fa space = one;
@@ -1248,6 +1570,17 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcGetGeometryTransformEx(RTCGeometry hgeometry, unsigned int instPrimID, float time, RTCFormat format, void* xfm)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetGeometryTransformEx);
+    RTC_ENTER_DEVICE(hgeometry);
+    const AffineSpace3fa transform = geometry->getTransform(instPrimID, time);
+    storeTransform(transform, format, (float*)xfm);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcInvokeIntersectFilterFromGeometry(const struct RTCIntersectFunctionNArguments* const args_i, const struct RTCFilterFunctionNArguments* filter_args)
   {
     IntersectFunctionNArguments* args = (IntersectFunctionNArguments*) args_i;
@@ -1418,6 +1751,22 @@ RTC_NAMESPACE_BEGIN;
 #endif
     }
 
+    case RTC_GEOMETRY_TYPE_INSTANCE_ARRAY:
+    {
+#if defined(EMBREE_GEOMETRY_INSTANCE_ARRAY)
+#if defined(EMBREE_SYCL_SUPPORT)
+      if (dynamic_cast<DeviceGPU*>(device))
+        throw_RTCError(RTC_ERROR_UNKNOWN,"RTC_GEOMETRY_TYPE_INSTANCE_ARRAY is not supported on SYCL devices");
+#endif
+      createInstanceArrayTy createInstanceArray = nullptr;
+      SELECT_SYMBOL_DEFAULT_AVX_AVX2_AVX512(device->enabled_cpu_features,createInstanceArray);
+      Geometry* geom = createInstanceArray(device);
+      return (RTCGeometry) geom->refInc();
+#else
+      throw_RTCError(RTC_ERROR_UNKNOWN,"RTC_GEOMETRY_TYPE_INSTANCE_ARRAY is not supported");
+#endif
+    }
+
     case RTC_GEOMETRY_TYPE_GRID:
     {
 #if defined(EMBREE_GEOMETRY_GRID)
@@ -1658,7 +2007,18 @@ RTC_NAMESPACE_BEGIN;
     RTC_TRACE(rtcUpdateGeometryBuffer);
     RTC_VERIFY_HANDLE(hgeometry);
     RTC_ENTER_DEVICE(hgeometry);
-    geometry->updateBuffer(type, slot);
+    geometry->updateBufferPrimitiveRange(type, slot, 0, (unsigned int)geometry->size());
+    RTC_CATCH_END2(geometry);
+  }
+
+  RTC_API void rtcUpdateGeometryBufferPrimitiveRange (RTCGeometry hgeometry, RTCBufferType type, unsigned int slot, unsigned int primBegin, unsigned int primCount)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcUpdateGeometryBufferPrimitiveRange);
+    RTC_VERIFY_HANDLE(hgeometry);
+    RTC_ENTER_DEVICE(hgeometry);
+    geometry->updateBufferPrimitiveRange(type, slot, primBegin, primCount);
     RTC_CATCH_END2(geometry);
   }
 
@@ -10,6 +10,9 @@
 
 #include "../../common/algorithms/parallel_reduce.h"
 
+#include "../hash.h"
+#include <fstream>
+
 #if defined(EMBREE_SYCL_SUPPORT)
 #  include "../rthwif/rthwif_embree_builder.h"
 #endif
@@ -47,7 +50,8 @@ namespace embree
       quality_flags(RTC_BUILD_QUALITY_MEDIUM),
       modified(true),
       taskGroup(new TaskGroup()),
-      progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0)
+      progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0),
+      commit_cancelled(false)
   {
     device->refInc();
 
@@ -68,6 +72,8 @@ namespace embree
 
   Scene::~Scene() noexcept
   {
+    /* acceleration structures account their memory to the scene, thus have to get destroyed first */
+    accels_init();
     device->refDec();
   }
   
@@ -591,6 +597,18 @@ namespace embree
 #endif
   }
 
+  void Scene::createInstanceArrayAccel()
+  {
+#if defined(EMBREE_GEOMETRY_INSTANCE_ARRAY)
+#if defined (EMBREE_TARGET_SIMD8)
+    if (device->canUseAVX() && !isCompactAccel())
+      accels_add(device->bvh8_factory->BVH8InstanceArray(this));
+    else
+#endif
+      accels_add(device->bvh4_factory->BVH4InstanceArray(this));
+#endif
+  }
+
   void Scene::createGridAccel()
   {
 #if defined(EMBREE_GEOMETRY_GRID)
@@ -681,47 +699,67 @@ namespace embree
     geometryModCounters_[geomID] = 0;
   }
 
-  void Scene::build_cpu_accels()
+  void Scene::create_cpu_accels()
   {
-    /* select acceleration structures to build */
-    unsigned int new_enabled_geometry_types = world.enabledGeometryTypesMask();
+    accels_init();
 
-    if (flags_modified || new_enabled_geometry_types != enabled_geometry_types)
-    {
-      accels_init();
+    /* we need to make all geometries modified, otherwise two level builder will 
+      not rebuild currently not modified geometries */
+    parallel_for(geometryModCounters_.size(), [&] ( const size_t i ) {
+        geometryModCounters_[i] = 0;
+      });
 
-      /* we need to make all geometries modified, otherwise two level builder will 
-        not rebuild currently not modified geometries */
-      parallel_for(geometryModCounters_.size(), [&] ( const size_t i ) {
-          geometryModCounters_[i] = 0;
-        });
+    if (getNumPrimitives(TriangleMesh::geom_type,false)) createTriangleAccel();
+    if (getNumPrimitives(TriangleMesh::geom_type,true)) createTriangleMBAccel();
+    if (getNumPrimitives(QuadMesh::geom_type,false)) createQuadAccel();
+    if (getNumPrimitives(QuadMesh::geom_type,true)) createQuadMBAccel();
+    if (getNumPrimitives(GridMesh::geom_type,false)) createGridAccel();
+    if (getNumPrimitives(GridMesh::geom_type,true)) createGridMBAccel();
+    if (getNumPrimitives(SubdivMesh::geom_type,false)) createSubdivAccel();
+    if (getNumPrimitives(SubdivMesh::geom_type,true)) createSubdivMBAccel();
+    if (getNumPrimitives(Geometry::MTY_CURVES,false)) createHairAccel();
+    if (getNumPrimitives(Geometry::MTY_CURVES,true)) createHairMBAccel();
+    if (getNumPrimitives(UserGeometry::geom_type,false)) createUserGeometryAccel();
+    if (getNumPrimitives(UserGeometry::geom_type,true)) createUserGeometryMBAccel();      
+    if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,false)) createInstanceAccel();
+    if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,true)) createInstanceMBAccel();
+    if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,false)) createInstanceExpensiveAccel();
+    if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,true)) createInstanceExpensiveMBAccel();
+    if (getNumPrimitives(Geometry::MTY_INSTANCE_ARRAY,false)) createInstanceArrayAccel();
+
+    flags_modified = false;
+    enabled_geometry_types = world.enabledGeometryTypesMask();
+  }
 
-      if (getNumPrimitives(TriangleMesh::geom_type,false)) createTriangleAccel();
-      if (getNumPrimitives(TriangleMesh::geom_type,true)) createTriangleMBAccel();
-      if (getNumPrimitives(QuadMesh::geom_type,false)) createQuadAccel();
-      if (getNumPrimitives(QuadMesh::geom_type,true)) createQuadMBAccel();
-      if (getNumPrimitives(GridMesh::geom_type,false)) createGridAccel();
-      if (getNumPrimitives(GridMesh::geom_type,true)) createGridMBAccel();
-      if (getNumPrimitives(SubdivMesh::geom_type,false)) createSubdivAccel();
-      if (getNumPrimitives(SubdivMesh::geom_type,true)) createSubdivMBAccel();
-      if (getNumPrimitives(Geometry::MTY_CURVES,false)) createHairAccel();
-      if (getNumPrimitives(Geometry::MTY_CURVES,true)) createHairMBAccel();
-      if (getNumPrimitives(UserGeometry::geom_type,false)) createUserGeometryAccel();
-      if (getNumPrimitives(UserGeometry::geom_type,true)) createUserGeometryMBAccel();      
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,false)) createInstanceAccel();
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,true)) createInstanceMBAccel();
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,false)) createInstanceExpensiveAccel();
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,true)) createInstanceExpensiveMBAccel();
-
-      flags_modified = false;
-      enabled_geometry_types = new_enabled_geometry_types;
-    }
+  void Scene::build_cpu_accels()
+  {
+    /* select acceleration structures to build */
+    if (flags_modified || world.enabledGeometryTypesMask() != enabled_geometry_types)
+      create_cpu_accels();
     
     /* select fast code path if no filter function is present */
     accels_select(hasFilterFunction());
   
     /* build all hierarchies of this scene */
-    accels_build();
+    memoryBudget.exceeded = false;
+    try {
+      accels_build();
+    }
+    catch (const rtcore_error& e)
+    {
+      /* switch to compact acceleration structures once if the memory budget got exceeded */
+      if (e.error != RTC_ERROR_OUT_OF_MEMORY || !memoryBudget.exceeded || isCompactAccel())
+        throw;
+
+      if (device->verbosity(1))
+        std::cout << "scene memory budget exceeded, rebuilding with compact acceleration structures" << std::endl;
+
+      scene_flags = (RTCSceneFlags) (scene_flags | RTC_SCENE_FLAG_COMPACT);
+      memoryBudget.exceeded = false;
+      create_cpu_accels();
+      accels_select(hasFilterFunction());
+      accels_build();
+    }
 
     /* make static geometry immutable */
     if (!isDynamicAccel()) {
@@ -756,7 +794,22 @@ namespace embree
       printStatistics();
 
     progress_monitor_counter = 0;
-    
+
+    precommit_geometries();
+
+#if defined(EMBREE_SYCL_SUPPORT)
+    if (DeviceGPU* gpu_device = dynamic_cast<DeviceGPU*>(device))
+      build_gpu_accels();
+    else
+#endif
+      build_cpu_accels();
+
+    postcommit_geometries();
+    setModified(false);
+  }
+
+  void Scene::precommit_geometries()
+  {
     /* gather scene stats and call preCommit function of each geometry */
     this->world = parallel_reduce (size_t(0), geometries.size(), GeometryCounts (), 
       [this](const range<size_t>& r)->GeometryCounts
@@ -776,14 +829,10 @@ namespace embree
       },
       std::plus<GeometryCounts>()
     );
+  }
 
-#if defined(EMBREE_SYCL_SUPPORT)
-    if (DeviceGPU* gpu_device = dynamic_cast<DeviceGPU*>(device))
-      build_gpu_accels();
-    else
-#endif
-      build_cpu_accels();
-
+  void Scene::postcommit_geometries()
+  {
     /* call postCommit function of each geometry */
     parallel_for(geometries.size(), [&] ( const size_t i ) {
         if (geometries[i] && geometries[i]->isEnabled()) {
@@ -792,8 +841,186 @@ namespace embree
           geometryModCounters_[i] = geometries[i]->getModCounter();
         }
       });
+  }
+
+  /*! magic number and version of stored BVH files */
+  static const char BVH_FILE_MAGIC[8] = { 'E','M','B','R','E','E','B','V' };
+  static const uint32_t BVH_FILE_VERSION = 1;
+
+  /*! FNV-1a hash used to reject BVH files that do not match the library or scene */
+  struct BVHFileHash
+  {
+    BVHFileHash () : h(0xcbf29ce484222325ull) {}
+
+    void add(const void* ptr, size_t bytes)
+    {
+      for (size_t i=0; i<bytes; i++) {
+        h ^= ((const unsigned char*)ptr)[i];
+        h *= 0x100000001b3ull;
+      }
+    }
+
+    template<typename T>
+    void add(const T& v) { add(&v,sizeof(T)); }
+
+    void add(const char* str) { add(str,strlen(str)+1); }
+
+    uint64_t h;
+  };
+
+  /*! hash of the library version, ISA and configuration the stored BVH depends on */
+  static uint64_t bvhFileConfigHash(Device* device)
+  {
+    BVHFileHash hash;
+    hash.add(RTC_VERSION_STRING);
+    hash.add(RTC_HASH);
+    hash.add(sizeof(void*));
+    hash.add(device->enabled_cpu_features);
+    hash.add(device->enabled_builder_cpu_features);
+#if defined(EMBREE_COMPACT_POLYS)
+    hash.add("EMBREE_COMPACT_POLYS");
+#endif
+    return hash.h;
+  }
 
+  /*! hash of the scene configuration and geometry layout the stored BVH got built for */
+  static uint64_t bvhFileSceneHash(Scene* scene)
+  {
+    BVHFileHash hash;
+    hash.add(scene->getSceneFlags());
+    hash.add(scene->getBuildQuality());
+    hash.add(scene->size());
+    for (size_t i=0; i<scene->size(); i++)
+    {
+      Geometry* geom = scene->get(i);
+      const bool enabled = geom && geom->isEnabled();
+      hash.add(enabled);
+      if (!enabled) continue;
+      hash.add(geom->getType());
+      hash.add(geom->size());
+      hash.add(geom->numTimeSteps);
+    }
+    return hash.h;
+  }
+
+  void Scene::saveBVH(const char* filename)
+  {
+    Lock<MutexSys> lock(buildMutex);
+
+#if defined(EMBREE_SYCL_SUPPORT)
+    if (dynamic_cast<DeviceGPU*>(device))
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"storing BVH not supported on GPU devices");
+#endif
+
+    if (isModified())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (isDynamicAccel())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"storing BVH not supported for dynamic scenes");
+
+    std::ofstream file(filename,std::ios::binary);
+    if (!file)
+      throw_RTCError(RTC_ERROR_UNKNOWN,"cannot open file " + std::string(filename));
+
+    file.write(BVH_FILE_MAGIC,sizeof(BVH_FILE_MAGIC));
+    const uint32_t version = BVH_FILE_VERSION;
+    const uint64_t configHash = bvhFileConfigHash(device);
+    const uint64_t sceneHash = bvhFileSceneHash(this);
+    const uint64_t numAccels = accels.size();
+    file.write((const char*)&version,sizeof(version));
+    file.write((const char*)&configHash,sizeof(configHash));
+    file.write((const char*)&sceneHash,sizeof(sceneHash));
+    file.write((const char*)&numAccels,sizeof(numAccels));
+
+    for (size_t i=0; i<accels.size(); i++)
+      if (!accels[i]->save(file))
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"storing BVH not supported for this acceleration structure");
+
+    if (!file)
+      throw_RTCError(RTC_ERROR_UNKNOWN,"error writing file " + std::string(filename));
+  }
+
+  bool Scene::loadBVH(const char* filename)
+  {
+    Lock<MutexSys> lock(buildMutex);
+
+#if defined(EMBREE_SYCL_SUPPORT)
+    if (dynamic_cast<DeviceGPU*>(device))
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"loading BVH not supported on GPU devices");
+#endif
+
+    if (isDynamicAccel())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"loading BVH not supported for dynamic scenes");
+
+    /* reject files of other library versions, ISAs, or scene layouts */
+    std::ifstream file(filename,std::ios::binary);
+    if (!file) return false;
+
+    char magic[sizeof(BVH_FILE_MAGIC)];
+    uint32_t version = 0;
+    uint64_t configHash = 0, sceneHash = 0, numAccels = 0;
+    file.read(magic,sizeof(magic));
+    file.read((char*)&version,sizeof(version));
+    file.read((char*)&configHash,sizeof(configHash));
+    file.read((char*)&sceneHash,sizeof(sceneHash));
+    file.read((char*)&numAccels,sizeof(numAccels));
+    if (!file || memcmp(magic,BVH_FILE_MAGIC,sizeof(magic)) != 0 || version != BVH_FILE_VERSION)
+      return false;
+    if (configHash != bvhFileConfigHash(device) || sceneHash != bvhFileSceneHash(this))
+      return false;
+
+    /* create the same acceleration structures a commit would build, but restore their data from the file */
+    precommit_geometries();
+    create_cpu_accels();
+    accels_select(hasFilterFunction());
+
+    bool valid = numAccels == accels.size();
+    for (size_t i=0; valid && i<accels.size(); i++)
+      valid = accels[i]->load(file);
+
+    /* static scenes re-create their acceleration structures on next commit */
+    flags_modified = true;
+
+    /* on failure the scene stays empty until the next commit */
+    accels_immutable();
+    if (!valid) accels_clear();
+    accels_build();
+
+    if (!valid) {
+      setModified();
+      return false;
+    }
+
+    postcommit_geometries();
     setModified(false);
+    return true;
+  }
+
+  void Scene::setMemoryBudget(size_t bytes) {
+    memoryBudget.bytesBudget = bytes;
+  }
+
+  size_t Scene::getMemoryStatistics(RTCSceneMemoryStatistics* stats, size_t maxStats)
+  {
+    Lock<MutexSys> lock(buildMutex);
+
+    if (isModified())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+
+    for (size_t i=0; i<min(accels.size(),maxStats); i++) {
+      memset(&stats[i],0,sizeof(RTCSceneMemoryStatistics));
+      accels[i]->getMemoryStatistics(stats[i]);
+    }
+    return accels.size();
+  }
+
+  void Scene::MemoryBudgetInterface::memoryMonitor(ssize_t bytes, bool post)
+  {
+    const ssize_t used = bytesUsed.fetch_add(bytes)+bytes;
+    if (bytes > 0 && bytesBudget != 0 && used > ssize_t(bytesBudget)) { // only throw exception when we allocate memory to never throw inside a destructor
+      bytesUsed -= bytes;
+      exceeded = true;
+      throw_RTCError(RTC_ERROR_OUT_OF_MEMORY,"scene memory budget exceeded");
+    }
   }
 
   void Scene::setBuildQuality(RTCBuildQuality quality_flags_i)
@@ -974,6 +1201,9 @@ namespace embree
 
   void Scene::progressMonitor(double dn)
   {
+    if (commit_cancelled)
+      throw_RTCError(RTC_ERROR_CANCELLED,"commit cancelled");
+
     if (progress_monitor_function) {
       size_t n = size_t(dn) + progress_monitor_counter.fetch_add(size_t(dn));
       if (!progress_monitor_function(progress_monitor_ptr, n / (double(numPrimitives())))) {
@@ -981,4 +1211,63 @@ namespace embree
       }
     }
   }
+
+  SceneCommit::SceneCommit (Scene* scene, RTCSceneCommitFunction func, void* userPtr)
+    : scene(scene), func(func), userPtr(userPtr), thread(nullptr), finished(false), error(RTC_ERROR_NONE)
+  {
+    scene->commit_cancelled = false;
+    thread = createThread(run,this);
+  }
+
+  SceneCommit::~SceneCommit () {
+    wait();
+  }
+
+  void SceneCommit::run(void* ptr)
+  {
+    SceneCommit* This = (SceneCommit*) ptr;
+    Scene* scene = This->scene.ptr;
+
+    RTCError error = RTC_ERROR_NONE;
+    try {
+      DeviceEnterLeave enterleave((RTCScene)scene);
+      scene->commit(false);
+    } catch (std::bad_alloc&) {
+      error = RTC_ERROR_OUT_OF_MEMORY;
+      Device::process_error(scene->device,error,"out of memory");
+    } catch (rtcore_error& e) {
+      error = e.error;
+      Device::process_error(scene->device,error,e.what());
+    } catch (std::exception& e) {
+      error = RTC_ERROR_UNKNOWN;
+      Device::process_error(scene->device,error,e.what());
+    } catch (...) {
+      error = RTC_ERROR_UNKNOWN;
+      Device::process_error(scene->device,error,"unknown exception caught");
+    }
+
+    if (This->func)
+      This->func(This->userPtr,error);
+
+    Lock<MutexSys> lock(This->stateMutex);
+    scene->commit_cancelled = false;
+    This->error = error;
+    This->finished = true;
+  }
+
+  RTCError SceneCommit::wait()
+  {
+    Lock<MutexSys> lock(joinMutex);
+    if (thread) {
+      join(thread);
+      thread = nullptr;
+    }
+    return error;
+  }
+
+  void SceneCommit::cancel()
+  {
+    Lock<MutexSys> lock(stateMutex);
+    if (!finished) scene->commit_cancelled = true;
+  }
 }
@@ -10,6 +10,7 @@
 #include "scene_quad_mesh.h"
 #include "scene_user_geometry.h"
 #include "scene_instance.h"
+#include "scene_instance_array.h"
 #include "scene_curves.h"
 #include "scene_line_segments.h"
 #include "scene_subdiv_mesh.h"
@@ -165,6 +166,7 @@ namespace embree
     void createInstanceMBAccel();
     void createInstanceExpensiveAccel();
     void createInstanceExpensiveMBAccel();
+    void createInstanceArrayAccel();
     void createGridAccel();
     void createGridMBAccel();
 
@@ -183,10 +185,25 @@ namespace embree
     void setSceneFlags(RTCSceneFlags scene_flags);
     RTCSceneFlags getSceneFlags() const;
 
+    void create_cpu_accels();
     void build_cpu_accels();
     void build_gpu_accels();
+    void precommit_geometries();
+    void postcommit_geometries();
     void commit (bool join);
     void commit_task ();
+
+    /*! stores the acceleration structures of the committed scene into a file */
+    void saveBVH(const char* filename);
+
+    /*! commits the scene by restoring its acceleration structures from a file, returns false if the file does not match the scene */
+    bool loadBVH(const char* filename);
+
+    /*! sets the number of bytes the acceleration structures may allocate, 0 disables the budget */
+    void setMemoryBudget(size_t bytes);
+
+    /*! gathers memory statistics of each acceleration structure, returns the number of acceleration structures */
+    size_t getMemoryStatistics(RTCSceneMemoryStatistics* stats, size_t maxStats);
     void build () {}
 
     /* return number of geometries */
@@ -312,9 +329,23 @@ namespace embree
     RTCProgressMonitorFunction progress_monitor_function;
     void* progress_monitor_ptr;
     std::atomic<size_t> progress_monitor_counter;
+    std::atomic<bool> commit_cancelled;   //!< set to cancel the currently running asynchronous commit
     void progressMonitor(double nprims);
     void setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr);
 
+  public:
+    /*! accounts the blocks of all acceleration structures of the scene against the memory budget */
+    struct MemoryBudgetInterface : public MemoryMonitorInterface {
+      MemoryBudgetInterface()
+      : bytesBudget(0), bytesUsed(0), exceeded(false) {}
+      void memoryMonitor(ssize_t bytes, bool post);
+    public:
+      size_t bytesBudget;             //!< maximal number of bytes, 0 if unlimited
+      std::atomic<ssize_t> bytesUsed; //!< number of bytes currently accounted
+      std::atomic<bool> exceeded;     //!< true if an allocation got rejected
+    };
+    MemoryBudgetInterface memoryBudget;
+
   private:
     GeometryCounts world;               //!< counts for geometry
 
@@ -355,6 +386,9 @@ namespace embree
       if (mask & Geometry::MTY_INSTANCE_EXPENSIVE)
         count += mblur  ? world.numMBInstancesExpensive : world.numInstancesExpensive;
       
+      if (mask & Geometry::MTY_INSTANCE_ARRAY)
+        count += mblur  ? world.numMBInstanceArrays : world.numInstanceArrays;
+      
       if (mask & Geometry::MTY_GRID_MESH)
         count += mblur  ? world.numMBGrids : world.numGrids;
       
@@ -391,4 +425,37 @@ namespace embree
       return iter.maxGeomID();
     }
   };
+
+  /*! commit of a scene running asynchronously on its own thread */
+  class SceneCommit : public RefCount
+  {
+  public:
+    SceneCommit (Scene* scene, RTCSceneCommitFunction func, void* userPtr);
+    ~SceneCommit ();
+
+    /*! returns the scene that gets committed */
+    Scene* getScene() { return scene.ptr; }
+
+    /*! returns true if the commit finished */
+    bool isDone() const { return finished; }
+
+    /*! waits for the commit to finish and returns its error code */
+    RTCError wait();
+
+    /*! requests cancellation of the commit, the commit then fails with RTC_ERROR_CANCELLED */
+    void cancel();
+
+  private:
+    static void run(void* ptr);
+
+  private:
+    Ref<Scene> scene;
+    RTCSceneCommitFunction func;   //!< optional callback invoked from the build thread when the commit finished
+    void* userPtr;
+    thread_t thread;
+    MutexSys joinMutex;            //!< serializes joining of the build thread
+    MutexSys stateMutex;           //!< makes cancellation and completion mutually exclusive
+    std::atomic<bool> finished;
+    RTCError error;
+  };
 }
@@ -0,0 +1,172 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "scene_instance_array.h"
+#include "scene.h"
+
+namespace embree
+{
+#if defined(EMBREE_LOWEST_ISA)
+
+  InstanceArray::InstanceArray (Device* device)
+    : Geometry(device,Geometry::GTY_INSTANCE_ARRAY,0,1)
+    , objects(nullptr)
+    , numObjects(0)
+  {
+  }
+
+  InstanceArray::~InstanceArray()
+  {
+    clearObjects();
+  }
+
+  void InstanceArray::clearObjects()
+  {
+    for (size_t i = 0; i < numObjects; i++)
+      if (objects[i]) objects[i]->refDec();
+    device->free(objects);
+    objects = nullptr;
+    numObjects = 0;
+  }
+
+  void InstanceArray::setNumTimeSteps (unsigned int numTimeSteps_in)
+  {
+    if (numTimeSteps_in != 1)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"motion blur not supported for instance arrays");
+  }
+
+  void InstanceArray::setInstancedScene(const Ref<Scene>& scene)
+  {
+    RTCScene hscene = (RTCScene) scene.ptr;
+    setInstancedScenes(&hscene,1);
+  }
+
+  void InstanceArray::setInstancedScenes(const RTCScene* scenes, size_t numScenes)
+  {
+    if (numScenes > 0 && scenes == nullptr)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid scene array");
+
+    Accel** objects2 = (Accel**) device->malloc(max(numScenes,size_t(1))*sizeof(Accel*),16);
+    for (size_t i = 0; i < numScenes; i++) {
+      objects2[i] = (Scene*) scenes[i];
+      if (objects2[i]) objects2[i]->refInc();
+    }
+
+    clearObjects();
+    objects = objects2;
+    numObjects = (unsigned int) numScenes;
+    Geometry::update();
+  }
+
+  void InstanceArray::setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num)
+  {
+    /* verify that all accesses are 4 bytes aligned */
+    if (((size_t(buffer->getPtr()) + offset) & 0x3) || (stride & 0x3))
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION, "data must be 4 bytes aligned");
+
+    if (type == RTC_BUFFER_TYPE_TRANSFORM)
+    {
+      if (slot != 0)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+      if (format != RTC_FORMAT_FLOAT3X4_ROW_MAJOR &&
+          format != RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR &&
+          format != RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid transform buffer format");
+
+      l2w_buf.set(buffer, offset, stride, num, format);
+      setNumPrimitives(num);
+    }
+    else if (type == RTC_BUFFER_TYPE_INDEX)
+    {
+      if (slot != 0)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+      if (format != RTC_FORMAT_UINT)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid index buffer format");
+
+      object_ids.set(buffer, offset, stride, num, format);
+    }
+    else
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown buffer type");
+  }
+
+  void* InstanceArray::getBuffer(RTCBufferType type, unsigned int slot)
+  {
+    if (slot != 0)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+
+    if (type == RTC_BUFFER_TYPE_TRANSFORM)
+      return l2w_buf.getPtr();
+    else if (type == RTC_BUFFER_TYPE_INDEX)
+      return object_ids.getPtr();
+    else
+    {
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown buffer type");
+      return nullptr;
+    }
+  }
+
+  void InstanceArray::updateBuffer(RTCBufferType type, unsigned int slot)
+  {
+    if (slot != 0)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+
+    if (type == RTC_BUFFER_TYPE_TRANSFORM)
+      l2w_buf.setModified();
+    else if (type == RTC_BUFFER_TYPE_INDEX)
+      object_ids.setModified();
+    else
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown buffer type");
+
+    Geometry::update();
+  }
+
+  void InstanceArray::addElementsToCount (GeometryCounts & counts) const
+  {
+    if (1 == numTimeSteps)
+      counts.numInstanceArrays += numPrimitives;
+    else
+      counts.numMBInstanceArrays += numPrimitives;
+  }
+
+  AffineSpace3fa InstanceArray::getTransform(size_t instPrimID, float time)
+  {
+    if (instPrimID >= numPrimitives)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid instance primitive ID");
+    return getLocal2World(instPrimID);
+  }
+
+  void InstanceArray::setMask (unsigned mask)
+  {
+    this->mask = mask;
+    Geometry::update();
+  }
+
+  void InstanceArray::commit()
+  {
+    if (numPrimitives && !l2w_buf)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"transform buffer not set");
+
+    if (numPrimitives && numObjects == 0)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"no instanced scene set");
+
+    if (object_ids)
+    {
+      if (object_ids.size() < numPrimitives)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"index buffer smaller than transform buffer");
+
+      for (size_t i = 0; i < numPrimitives; i++)
+        if (object_ids[i] >= numObjects)
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid instanced scene index");
+    }
+
+    Geometry::commit();
+  }
+#endif
+
+  namespace isa
+  {
+    InstanceArray* createInstanceArray(Device* device) {
+      return new InstanceArrayISA(device);
+    }
+  }
+}
@@ -0,0 +1,140 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "geometry.h"
+#include "accel.h"
+
+namespace embree
+{
+  /*! Array of instances sharing one geometry ID. Each element has its
+   *  own transformation and optionally references one of several
+   *  instanced scenes. Only the local to world transformations are
+   *  stored, the inverse is calculated on demand to keep the memory
+   *  consumption per instance low. */
+  struct InstanceArray : public Geometry
+  {
+    static const Geometry::GTypeMask geom_type = Geometry::MTY_INSTANCE_ARRAY;
+
+  public:
+    InstanceArray (Device* device);
+    ~InstanceArray();
+
+  private:
+    InstanceArray (const InstanceArray& other) DELETED; // do not implement
+    InstanceArray& operator= (const InstanceArray& other) DELETED; // do not implement
+
+  public:
+    virtual void setNumTimeSteps (unsigned int numTimeSteps) override;
+    virtual void setInstancedScene(const Ref<Scene>& scene) override;
+    virtual void setInstancedScenes(const RTCScene* scenes, size_t numScenes) override;
+    virtual AffineSpace3fa getTransform(size_t instPrimID, float time) override;
+    virtual void setMask (unsigned mask) override;
+    virtual void setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num) override;
+    virtual void* getBuffer(RTCBufferType type, unsigned int slot) override;
+    virtual void updateBuffer(RTCBufferType type, unsigned int slot) override;
+    virtual void build() {}
+    virtual void addElementsToCount (GeometryCounts & counts) const override;
+    virtual void commit() override;
+
+  private:
+    void clearObjects();
+
+  public:
+
+    /*! returns the instanced scene of the i'th instance */
+    __forceinline Accel* getObject(size_t i) const
+    {
+      if (!object_ids) return objects[0];
+      const unsigned int id = object_ids[i];
+      assert(id < numObjects);
+      return objects[id];
+    }
+
+    /*! returns the local to world transformation of the i'th instance */
+    __forceinline AffineSpace3fa getLocal2World(size_t i) const
+    {
+      const float* xfm = (const float*) l2w_buf.getPtr(i);
+      switch (l2w_buf.getFormat())
+      {
+      case RTC_FORMAT_FLOAT3X4_ROW_MAJOR:
+        return AffineSpace3fa(Vec3fa(xfm[ 0], xfm[ 4], xfm[ 8]),
+                              Vec3fa(xfm[ 1], xfm[ 5], xfm[ 9]),
+                              Vec3fa(xfm[ 2], xfm[ 6], xfm[10]),
+                              Vec3fa(xfm[ 3], xfm[ 7], xfm[11]));
+      case RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR:
+        return AffineSpace3fa(Vec3fa(xfm[ 0], xfm[ 1], xfm[ 2]),
+                              Vec3fa(xfm[ 3], xfm[ 4], xfm[ 5]),
+                              Vec3fa(xfm[ 6], xfm[ 7], xfm[ 8]),
+                              Vec3fa(xfm[ 9], xfm[10], xfm[11]));
+      default: // RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR
+        return AffineSpace3fa(Vec3fa(xfm[ 0], xfm[ 1], xfm[ 2]),
+                              Vec3fa(xfm[ 4], xfm[ 5], xfm[ 6]),
+                              Vec3fa(xfm[ 8], xfm[ 9], xfm[10]),
+                              Vec3fa(xfm[12], xfm[13], xfm[14]));
+      }
+    }
+
+    /*! returns the world to local transformation of the i'th instance */
+    __forceinline AffineSpace3fa getWorld2Local(size_t i) const {
+      return rcp(getLocal2World(i));
+    }
+
+    /*! calculates the bounds of the i'th instance */
+    __forceinline BBox3fa bounds(size_t i) const
+    {
+      Accel* object = getObject(i);
+      if (object == nullptr) return empty;
+      return xfmBounds(getLocal2World(i),object->bounds.bounds());
+    }
+
+    /*! calculates the build bounds of the i'th item, if it's valid */
+    __forceinline bool buildBounds(size_t i, BBox3fa* bbox = nullptr) const
+    {
+      const BBox3fa b = bounds(i);
+      if (bbox) *bbox = b;
+      return isvalid(b);
+    }
+
+    /*! check if the i'th primitive is valid */
+    __forceinline bool valid(size_t i) const {
+      return isvalid(bounds(i));
+    }
+
+    __forceinline float projectedPrimitiveArea(const size_t i) const {
+      return area(bounds(i));
+    }
+
+  public:
+    Accel** objects;                 //!< instanced acceleration structures
+    unsigned int numObjects;         //!< number of instanced acceleration structures
+    RawBufferView l2w_buf;           //!< local to world transformation of each instance
+    BufferView<unsigned int> object_ids; //!< index into objects for each instance (optional)
+  };
+
+  namespace isa
+  {
+    struct InstanceArrayISA : public InstanceArray
+    {
+      InstanceArrayISA (Device* device)
+        : InstanceArray(device) {}
+
+      PrimInfo createPrimRefArray(PrimRef* prims, const range<size_t>& r, size_t k, unsigned int geomID) const
+      {
+        PrimInfo pinfo(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          BBox3fa bounds = empty;
+          if (!buildBounds(j,&bounds)) continue;
+          const PrimRef prim(bounds,geomID,unsigned(j));
+          pinfo.add_center2(prim);
+          prims[k++] = prim;
+        }
+        return pinfo;
+      }
+    };
+  }
+
+  DECLARE_ISA_FUNCTION(InstanceArray*, createInstanceArray, Device*);
+}
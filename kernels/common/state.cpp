@@ -83,8 +83,10 @@ namespace embree
 
     max_spatial_split_replications = 1.2f;
     useSpatialPreSplits = false;
+    bvh_reorder = false;
 
     tessellation_cache_size = 128*1024*1024;
+    tessellation_cache_max_size = 0;
 
     subdiv_accel = "default";
     subdiv_accel_mb = "default";
@@ -123,11 +125,14 @@ namespace embree
     hugepages = false;
 #endif
     hugepages_success = true;
+    numa = false;
 
     alloc_main_block_size = 0;
     alloc_num_main_slots = 0;
     alloc_thread_block_size = 0;
     alloc_single_thread_alloc = -1;
+    alloc_retain_blocks = false;
+    alloc_double_buffer = false;
 
     error_function = nullptr;
     error_function_userptr = nullptr;
@@ -291,6 +296,9 @@ namespace embree
       else if (tok == Token::Id("hugepages") && cin->trySymbol("=")) {
         hugepages = cin->get().Int();
       }
+      else if (tok == Token::Id("numa") && cin->trySymbol("=")) {
+        numa = cin->get().Int();
+      }
 
       else if (tok == Token::Id("float_exceptions") && cin->trySymbol("=")) 
         float_exceptions = cin->get().Int();
@@ -426,10 +434,15 @@ namespace embree
       else if (tok == Token::Id("presplits") && cin->trySymbol("="))
         useSpatialPreSplits = cin->get().Int() != 0 ? true : false;
 
+      else if (tok == Token::Id("bvh_reorder") && cin->trySymbol("="))
+        bvh_reorder = cin->get().Int() != 0 ? true : false;
+
       else if (tok == Token::Id("tessellation_cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
       else if (tok == Token::Id("cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
+      else if (tok == Token::Id("tessellation_cache_max_size") && cin->trySymbol("="))
+        tessellation_cache_max_size = size_t(cin->get().Float()*1024.0f*1024.0f);
 
       else if (tok == Token::Id("alloc_main_block_size") && cin->trySymbol("="))
         alloc_main_block_size = cin->get().Int();
@@ -439,6 +452,10 @@ namespace embree
          alloc_thread_block_size = cin->get().Int();
        else if (tok == Token::Id("alloc_single_thread_alloc") && cin->trySymbol("="))
          alloc_single_thread_alloc = cin->get().Int();
+       else if (tok == Token::Id("alloc_retain_blocks") && cin->trySymbol("="))
+         alloc_retain_blocks = cin->get().Int() != 0 ? true : false;
+       else if (tok == Token::Id("alloc_double_buffer") && cin->trySymbol("="))
+         alloc_double_buffer = cin->get().Int() != 0 ? true : false;
 
       cin->trySymbol(","); // optional , separator
     }
@@ -468,9 +485,13 @@ namespace embree
     else if (hugepages_success) std::cout << "enabled" << std::endl;
     else std::cout << "failed" << std::endl;
 
+    std::cout << "  numa               = " << numa << " (" << getNumberOfNumaNodes() << " nodes)" << std::endl;
+
     std::cout << "  verbosity          = " << verbose << std::endl;
     std::cout << "  cache_size         = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
+    std::cout << "  cache_max_size     = " << float(tessellation_cache_max_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  bvh_reorder        = " << bvh_reorder << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel              = " << tri_accel << std::endl;
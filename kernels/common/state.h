@@ -108,7 +108,9 @@ namespace embree
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
     bool useSpatialPreSplits;              //!< use spatial pre-splits instead of the full spatial split builder
+    bool bvh_reorder;                      //!< reorder nodes and leaves of static BVHs into treelets after the build
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
+    size_t tessellation_cache_max_size;    //!< size the shared tessellation cache may grow to when thrashing
 
   public:
     size_t instancing_open_min;            //!< instancing opens tree to minimally that number of subtrees
@@ -139,12 +141,15 @@ namespace embree
     bool enable_selockmemoryprivilege;     //!< configures the SeLockMemoryPrivilege under Windows to enable huge pages
     bool hugepages;                        //!< true if huge pages should get used
     bool hugepages_success;                //!< status for enabling huge pages
+    bool numa;                             //!< true if allocator blocks should get placed on the NUMA node of the building thread
 
   public:
     size_t alloc_main_block_size;          //!< main allocation block size (shared between threads)
     int alloc_num_main_slots;              //!< number of such shared blocks to be used to allocate
     size_t alloc_thread_block_size;        //!< size of thread local allocator block size
     int alloc_single_thread_alloc;         //!< in single mode nodes and leaves use same thread local allocator
+    bool alloc_retain_blocks;              //!< allocators of dynamic scenes keep their blocks across rebuilds
+    bool alloc_double_buffer;              //!< allocators of dynamic scenes keep the blocks of the previous build alive during a rebuild
 
   public:
 
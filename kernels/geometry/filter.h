@@ -12,6 +12,60 @@ namespace embree
 {
   namespace isa
   {
+    /*! inserts a hit into the sorted hit buffer of a multi-hit query,
+     *  returns the distance of the farthest buffered hit when the buffer
+     *  is full and infinity otherwise */
+    __forceinline float insertMultiHit(RTCMultiHit* multiHit, float t, const RTCHit& hit)
+    {
+      const unsigned int maxHits = multiHit->maxHits;
+      unsigned int numHits = multiHit->numHits;
+      float* ts = multiHit->t;
+      RTCHit* hits = multiHit->hits;
+
+      /* ignore hits beyond the full buffer */
+      if (numHits == maxHits && t >= ts[numHits-1])
+        return ts[numHits-1];
+
+      /* ignore duplicated hits of primitives referenced by multiple leaves */
+      for (unsigned int i=numHits; i>0 && ts[i-1] >= t; i--)
+      {
+        const RTCHit& h = hits[i-1];
+        if (ts[i-1] != t || h.primID != hit.primID || h.geomID != hit.geomID) continue;
+        bool same = true;
+        for (unsigned l = 0; same && l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l) {
+          same = h.instID[l] == hit.instID[l];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+          same &= h.instPrimID[l] == hit.instPrimID[l];
+#endif
+          if (hit.instID[l] == RTC_INVALID_GEOMETRY_ID) break;
+        }
+        if (same) return numHits == maxHits ? ts[numHits-1] : float(inf);
+      }
+
+      /* insertion sort step, drops the farthest hit if the buffer is full */
+      if (numHits == maxHits) numHits--;
+      unsigned int i = numHits;
+      for (; i>0 && ts[i-1] > t; i--) {
+        ts[i] = ts[i-1];
+        hits[i] = hits[i-1];
+      }
+      ts[i] = t;
+      hits[i] = hit;
+      multiHit->numHits = ++numHits;
+      return numHits == maxHits ? ts[numHits-1] : float(inf);
+    }
+
+    /*! collects an accepted hit of a multi-hit query, the hit is only
+     *  reported to the traversal to shrink tfar once the buffer is full */
+    __forceinline bool collectMultiHit1(RTCFilterFunctionNArguments* args, RayQueryContext* context)
+    {
+      RayHit& ray = *(RayHit*)args->ray;
+      const float tmax = insertMultiHit(context->getMultiHit(),ray.tfar,*(RTCHit*)args->hit);
+      if (tmax == float(inf)) return false;
+      ray.tfar = tmax;
+      return true;
+    }
+
     __forceinline bool runIntersectionFilter1Helper(RTCFilterFunctionNArguments* args, const Geometry* const geometry, RayQueryContext* context)
     {
       if (geometry->intersectionFilterN)
@@ -30,6 +84,9 @@ namespace embree
         if (args->valid[0] == 0)
           return false;
       }
+
+      if (unlikely(context->hasMultiHit()))
+        return collectMultiHit1(args,context);
       
       copyHitToRay(*(RayHit*)args->ray,*(Hit*)args->hit);
       return true;
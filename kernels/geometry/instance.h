@@ -33,9 +33,31 @@ namespace embree
   public:
 
     InstancePrimitive (const Instance* instance, unsigned int instID) 
-    : instance(instance) 
-    , instID_(instID)
-    {}
+    : instID_(instID)
+    {
+      set(instance);
+    }
+
+    /* stores the data required for traversal inline, such that visiting the leaf does not touch the instance */
+    __forceinline void set(const Instance* instance)
+    {
+      const AffineSpace3fa xfm = instance->getWorld2Local();
+      world2local[ 0] = xfm.l.vx.x; world2local[ 1] = xfm.l.vx.y; world2local[ 2] = xfm.l.vx.z;
+      world2local[ 3] = xfm.l.vy.x; world2local[ 4] = xfm.l.vy.y; world2local[ 5] = xfm.l.vy.z;
+      world2local[ 6] = xfm.l.vz.x; world2local[ 7] = xfm.l.vz.y; world2local[ 8] = xfm.l.vz.z;
+      world2local[ 9] = xfm.p.x;    world2local[10] = xfm.p.y;    world2local[11] = xfm.p.z;
+      object = instance->object;
+      mask = instance->mask;
+    }
+
+    /* returns the world to local transformation of the first time step */
+    __forceinline AffineSpace3fa getWorld2Local() const
+    {
+      return AffineSpace3fa(Vec3fa(world2local[0],world2local[ 1],world2local[ 2]),
+                            Vec3fa(world2local[3],world2local[ 4],world2local[ 5]),
+                            Vec3fa(world2local[6],world2local[ 7],world2local[ 8]),
+                            Vec3fa(world2local[9],world2local[10],world2local[11]));
+    }
 
     __forceinline void fill(const PrimRef* prims, size_t& i, size_t end, Scene* scene)
     {
@@ -68,11 +90,14 @@ namespace embree
 
     /* Updates the primitive */
     __forceinline BBox3fa update(Instance* instance) {
+      set(instance);
       return instance->bounds(0);
     }
 
   public:
-    const Instance* instance;
+    float world2local[12];       //!< world to local transformation of the first time step, stored as 3x4 column-major matrix
+    Accel* object;               //!< instanced acceleration structure
+    unsigned int mask;           //!< ray mask of the instance
     const unsigned int instID_ = std::numeric_limits<unsigned int>::max ();
   };
 }
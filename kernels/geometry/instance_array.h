@@ -0,0 +1,56 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "primitive.h"
+#include "../common/scene_instance_array.h"
+
+namespace embree
+{
+  struct InstanceArrayPrimitive
+  {
+    struct Type : public PrimitiveType 
+    {
+      const char* name() const;
+      size_t sizeActive(const char* This) const;
+      size_t sizeTotal(const char* This) const;
+      size_t getBytes(const char* This) const;
+    };
+    static Type type;
+
+  public:
+
+    /* primitive supports multiple time segments */
+    static const bool singleTimeSegment = false;
+
+    /* Returns maximum number of stored primitives */
+    static __forceinline size_t max_size() { return 1; }
+
+    /* Returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return N; }
+
+  public:
+
+    InstanceArrayPrimitive (unsigned int instID, unsigned int primID) 
+    : instID_(instID) 
+    , primID_(primID)
+    {}
+
+    __forceinline void fill(const PrimRef* prims, size_t& i, size_t end, Scene* scene)
+    {
+      assert(end-i == 1);
+      const PrimRef& prim = prims[i]; i++;
+      new (this) InstanceArrayPrimitive(prim.geomID(), prim.primID());
+    }
+
+    /* Updates the primitive */
+    __forceinline BBox3fa update(InstanceArray* instance) {
+      return instance->bounds(primID_);
+    }
+
+  public:
+    unsigned int instID_ = std::numeric_limits<unsigned int>::max ();
+    unsigned int primID_ = std::numeric_limits<unsigned int>::max ();
+  };
+}
@@ -12,23 +12,21 @@ namespace embree
 
     void InstanceIntersector1::intersect(const Precalculations& pre, RayHit& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
-      const Instance* instance = prim.instance;
-
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      if ((ray.mask & instance->mask) == 0) 
+      if ((ray.mask & prim.mask) == 0) 
         return;
 #endif
       RTCRayQueryContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        const AffineSpace3fa world2local = instance->getWorld2Local();
+        const AffineSpace3fa world2local = prim.getWorld2Local();
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -37,11 +35,9 @@ namespace embree
     
     bool InstanceIntersector1::occluded(const Precalculations& pre, Ray& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
-      const Instance* instance = prim.instance;
-      
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      if ((ray.mask & instance->mask) == 0) 
+      if ((ray.mask & prim.mask) == 0) 
         return false;
 #endif
       
@@ -49,13 +45,13 @@ namespace embree
       bool occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        const AffineSpace3fa world2local = instance->getWorld2Local();
+        const AffineSpace3fa world2local = prim.getWorld2Local();
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
@@ -66,16 +62,16 @@ namespace embree
     
     bool InstanceIntersector1::pointQuery(PointQuery* query, PointQueryContext* context, const InstancePrimitive& prim)
     {
-      const Instance* instance = prim.instance;
+      const Instance* instance = context->scene->get<Instance>(prim.instID_);
 
       const AffineSpace3fa local2world = instance->getLocal2World();
-      const AffineSpace3fa world2local = instance->getWorld2Local();
+      const AffineSpace3fa world2local = prim.getWorld2Local();
       float similarityScale = 0.f;
       const bool similtude = context->query_type == POINT_QUERY_TYPE_SPHERE
                            && similarityTransform(world2local, &similarityScale);
       assert((similtude && similarityScale > 0) || !similtude);
 
-      if (likely(instance_id_stack::push(context->userContext, prim.instID_, world2local, local2world)))
+      if (likely(instance_id_stack::push(context->userContext, prim.instID_, 0, world2local, local2world)))
       {
         PointQuery query_inst;
         query_inst.time = query->time;
@@ -83,7 +79,7 @@ namespace embree
         query_inst.radius = query->radius * similarityScale;
 
         PointQueryContext context_inst(
-          (Scene*)instance->object, 
+          (Scene*)prim.object, 
           context->query_ws, 
           similtude ? POINT_QUERY_TYPE_SPHERE : POINT_QUERY_TYPE_AABB,
           context->func,
@@ -91,7 +87,7 @@ namespace embree
           similarityScale,
           context->userPtr);
 
-        bool changed = instance->object->intersectors.pointQuery(&query_inst, &context_inst);
+        bool changed = prim.object->intersectors.pointQuery(&query_inst, &context_inst);
         instance_id_stack::pop(context->userContext);
         return changed;
       }
@@ -100,11 +96,11 @@ namespace embree
 
     void InstanceIntersector1MB::intersect(const Precalculations& pre, RayHit& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
-      const Instance* instance = prim.instance;
+      const Instance* instance = context->scene->get<Instance>(prim.instID_);
       
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      if ((ray.mask & instance->mask) == 0) 
+      if ((ray.mask & prim.mask) == 0) 
         return;
 #endif
       
@@ -116,8 +112,8 @@ namespace embree
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -126,11 +122,11 @@ namespace embree
     
     bool InstanceIntersector1MB::occluded(const Precalculations& pre, Ray& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
-      const Instance* instance = prim.instance;
+      const Instance* instance = context->scene->get<Instance>(prim.instID_);
       
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      if ((ray.mask & instance->mask) == 0) 
+      if ((ray.mask & prim.mask) == 0) 
         return false;
 #endif
       
@@ -143,8 +139,8 @@ namespace embree
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
@@ -155,7 +151,7 @@ namespace embree
     
     bool InstanceIntersector1MB::pointQuery(PointQuery* query, PointQueryContext* context, const InstancePrimitive& prim)
     {
-      const Instance* instance = prim.instance;
+      const Instance* instance = context->scene->get<Instance>(prim.instID_);
 
       const AffineSpace3fa local2world = instance->getLocal2World(query->time);
       const AffineSpace3fa world2local = instance->getWorld2Local(query->time);
@@ -163,7 +159,7 @@ namespace embree
       const bool similtude = context->query_type == POINT_QUERY_TYPE_SPHERE
                            && similarityTransform(world2local, &similarityScale);
 
-      if (likely(instance_id_stack::push(context->userContext, prim.instID_, world2local, local2world)))
+      if (likely(instance_id_stack::push(context->userContext, prim.instID_, 0, world2local, local2world)))
       {
         PointQuery query_inst;
         query_inst.time = query->time;
@@ -171,7 +167,7 @@ namespace embree
         query_inst.radius = query->radius * similarityScale;
         
         PointQueryContext context_inst(
-          (Scene*)instance->object, 
+          (Scene*)prim.object, 
           context->query_ws, 
           similtude ? POINT_QUERY_TYPE_SPHERE : POINT_QUERY_TYPE_AABB,
           context->func, 
@@ -179,7 +175,7 @@ namespace embree
           similarityScale,
           context->userPtr); 
 
-        bool changed = instance->object->intersectors.pointQuery(&query_inst, &context_inst);
+        bool changed = prim.object->intersectors.pointQuery(&query_inst, &context_inst);
         instance_id_stack::pop(context->userContext);
         return changed;
       }
@@ -190,25 +186,24 @@ namespace embree
     void InstanceIntersectorK<K>::intersect(const vbool<K>& valid_i, const Precalculations& pre, RayHitK<K>& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
       vbool<K> valid = valid_i;
-      const Instance* instance = prim.instance;
       //ray.geomID = 10;
       
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      valid &= (ray.mask & instance->mask) != 0;
+      valid &= (ray.mask & prim.mask) != 0;
       if (none(valid)) return;
 #endif
         
       RTCRayQueryContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        AffineSpace3vf<K> world2local = instance->getWorld2Local();
+        AffineSpace3vf<K> world2local = prim.getWorld2Local();
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect(valid, ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.intersect(valid, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -219,11 +214,10 @@ namespace embree
     vbool<K> InstanceIntersectorK<K>::occluded(const vbool<K>& valid_i, const Precalculations& pre, RayK<K>& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
       vbool<K> valid = valid_i;
-      const Instance* instance = prim.instance;
       
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      valid &= (ray.mask & instance->mask) != 0;
+      valid &= (ray.mask & prim.mask) != 0;
       if (none(valid)) return false;
 #endif
         
@@ -231,13 +225,13 @@ namespace embree
       vbool<K> occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        AffineSpace3vf<K> world2local = instance->getWorld2Local();
+        AffineSpace3vf<K> world2local = prim.getWorld2Local();
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded(valid, ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.occluded(valid, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
@@ -250,11 +244,11 @@ namespace embree
     void InstanceIntersectorKMB<K>::intersect(const vbool<K>& valid_i, const Precalculations& pre, RayHitK<K>& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
       vbool<K> valid = valid_i;
-      const Instance* instance = prim.instance;
+      const Instance* instance = context->scene->get<Instance>(prim.instID_);
       
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      valid &= (ray.mask & instance->mask) != 0;
+      valid &= (ray.mask & prim.mask) != 0;
       if (none(valid)) return;
 #endif
         
@@ -266,8 +260,8 @@ namespace embree
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect(valid, ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.intersect(valid, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -278,11 +272,11 @@ namespace embree
     vbool<K> InstanceIntersectorKMB<K>::occluded(const vbool<K>& valid_i, const Precalculations& pre, RayK<K>& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
       vbool<K> valid = valid_i;
-      const Instance* instance = prim.instance;
+      const Instance* instance = context->scene->get<Instance>(prim.instID_);
       
       /* perform ray mask test */
 #if defined(EMBREE_RAY_MASK)
-      valid &= (ray.mask & instance->mask) != 0;
+      valid &= (ray.mask & prim.mask) != 0;
       if (none(valid)) return false;
 #endif
         
@@ -295,8 +289,8 @@ namespace embree
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
-        RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded(valid, ray, &newcontext);
+        RayQueryContext newcontext((Scene*)prim.object, user_context, context->args);
+        prim.object->intersectors.occluded(valid, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
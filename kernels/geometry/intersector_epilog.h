@@ -45,7 +45,7 @@ namespace embree
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          if (unlikely(context->hasContextFilter() || context->hasMultiHit() || geometry->hasIntersectionFilter())) {
             HitK<1> h(context->user,geomID,primID,hit.u,hit.v,hit.Ng);
             const float old_t = ray.tfar;
             ray.tfar = hit.t;
@@ -63,7 +63,11 @@ namespace embree
         ray.v = hit.v;
         ray.primID = primID;
         ray.geomID = geomID;
-        instance_id_stack::copy_UU(context->user->instID, ray.instID);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UU(context->user, ray.instID, ray.instPrimID);
+#else
+        instance_id_stack::copy_UU(context->user, ray.instID);
+#endif
         return true;
       }
     };
@@ -162,7 +166,11 @@ namespace embree
         ray.v[k] = hit.v;
         ray.primID[k] = primID;
         ray.geomID[k] = geomID;
-        instance_id_stack::copy_UV<K>(context->user->instID, ray.instID, k);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, ray.instPrimID, k);
+#else
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, k);
+#endif
         return true;
       }
     };
@@ -258,7 +266,7 @@ namespace embree
 #if defined(EMBREE_FILTER_FUNCTION) 
           /* call intersection filter function */
           if (filter) {
-            if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+            if (unlikely(context->hasContextFilter() || context->hasMultiHit() || geometry->hasIntersectionFilter())) {
               const Vec2f uv = hit.uv(i);
               HitK<1> h(context->user,geomID,primIDs[i],uv.x,uv.y,hit.Ng(i));
               const float old_t = ray.tfar;
@@ -286,7 +294,11 @@ namespace embree
         ray.v = uv.y;
         ray.primID = primIDs[i];
         ray.geomID = geomID;
-        instance_id_stack::copy_UU(context->user->instID, ray.instID);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UU(context->user, ray.instID, ray.instPrimID);
+#else
+        instance_id_stack::copy_UU(context->user, ray.instID);
+#endif
         return true;
 
       }
@@ -390,7 +402,7 @@ namespace embree
 
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
-        if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter()))
+        if (unlikely(context->hasContextFilter() || context->hasMultiHit() || geometry->hasIntersectionFilter()))
         {
           bool foundhit = false;
           while (true)
@@ -423,7 +435,11 @@ namespace embree
         ray.v = uv.y;
         ray.primID = primID;
         ray.geomID = geomID;
-        instance_id_stack::copy_UU(context->user->instID, ray.instID);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UU(context->user, ray.instID, ray.instPrimID);
+#else
+        instance_id_stack::copy_UU(context->user, ray.instID);
+#endif
         return true;
       }
     };
@@ -533,7 +549,11 @@ namespace embree
         vfloat<K>::store(valid,&ray.v,v);
         vuint<K>::store(valid,&ray.primID,primID);
         vuint<K>::store(valid,&ray.geomID,geomID);
-        instance_id_stack::copy_UV<K>(context->user->instID, ray.instID, valid);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, ray.instPrimID, valid);
+#else
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, valid);
+#endif
         return valid;
       }
     };
@@ -648,7 +668,11 @@ namespace embree
         vfloat<K>::store(valid,&ray.v,v);
         vuint<K>::store(valid,&ray.primID,primID);
         vuint<K>::store(valid,&ray.geomID,geomID);
-        instance_id_stack::copy_UV<K>(context->user->instID, ray.instID, valid);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, ray.instPrimID, valid);
+#else
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, valid);
+#endif
         return valid;
       }
     };
@@ -782,7 +806,11 @@ namespace embree
         ray.v[k] = uv.y;
         ray.primID[k] = primIDs[i];
         ray.geomID[k] = geomID;
-        instance_id_stack::copy_UV<K>(context->user->instID, ray.instID, k);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, ray.instPrimID, k);
+#else
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, k);
+#endif
         return true;
       }
     };
@@ -922,7 +950,11 @@ namespace embree
         ray.v[k] = uv.y;
         ray.primID[k] = primID;
         ray.geomID[k] = geomID;
-        instance_id_stack::copy_UV<K>(context->user->instID, ray.instID, k);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, ray.instPrimID, k);
+#else
+        instance_id_stack::copy_UV<K>(context->user, ray.instID, k);
+#endif
         return true;
       }
     };
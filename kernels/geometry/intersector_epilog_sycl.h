@@ -65,7 +65,11 @@ namespace embree
       ray.Ng.z = hit_i.Ng.z;
       ray.geomID = geomID;
       ray.primID = primID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      instance_id_stack::copy_UU(context->user, ray.instID, ray.instPrimID);
+#else
       instance_id_stack::copy_UU(context->user, ray.instID);
+#endif
       return true;
     }
     
@@ -109,7 +113,11 @@ namespace embree
       ray.Ng.z = Ng.z;
       ray.geomID = geomID;
       ray.primID = primID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      instance_id_stack::copy_UU(context->user, ray.instID, ray.instPrimID);
+#else
       instance_id_stack::copy_UU(context->user, ray.instID);
+#endif
       return true;
     }
   };
@@ -15,6 +15,7 @@
 #include "subdivpatch1.h"
 #include "object.h"
 #include "instance.h"
+#include "instance_array.h"
 #include "subgrid.h"
 
 namespace embree
@@ -335,6 +336,26 @@ namespace embree
 
   InstancePrimitive::Type InstancePrimitive::type;
 
+  /********************** InstanceArray **************************/
+
+  const char* InstanceArrayPrimitive::Type::name () const {
+    return "instance_array";
+  }
+
+  size_t InstanceArrayPrimitive::Type::sizeActive(const char* This) const {
+    return 1;
+  }
+
+  size_t InstanceArrayPrimitive::Type::sizeTotal(const char* This) const {
+    return 1;
+  }
+
+  size_t InstanceArrayPrimitive::Type::getBytes(const char* This) const {
+    return sizeof(InstanceArrayPrimitive);
+  }
+
+  InstanceArrayPrimitive::Type InstanceArrayPrimitive::type;
+
   /********************** SubGrid **************************/
 
   const char* SubGrid::Type::name () const {
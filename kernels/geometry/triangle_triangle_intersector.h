@@ -1,6 +1,8 @@
 // Copyright 2009-2021 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#pragma once
+
 #include "primitive.h"
 
 namespace embree
@@ -125,6 +127,96 @@ namespace embree
         
         return conjoint(ba,bb);
       }
+
+      template<int M>
+      __forceinline static void extend_interval(const vfloat<M>& p0, const vfloat<M>& p1, const vfloat<M>& d0, const vfloat<M>& d1,
+                                                vfloat<M>& lower, vfloat<M>& upper)
+      {
+        const vbool<M> crossing = (min(d0,d1) <= 0.0f) & (max(d0,d1) >= 0.0f) & (abs(d0-d1) > 0.0f);
+        const vfloat<M> t = p0 + (p1-p0)*d0/(d0-d1);
+        lower = select(crossing,min(lower,t),lower);
+        upper = select(crossing,max(upper,t),upper);
+      }
+
+      /*! intersects one triangle A with M triangles B, coplanar triangle pairs are resolved with the scalar test */
+      template<int M>
+      static vbool<M> intersect_triangle_triangle (const vbool<M>& valid_i,
+                                                   const Vec3fa& a0, const Vec3fa& a1, const Vec3fa& a2,
+                                                   const Vec3vf<M>& b0, const Vec3vf<M>& b1, const Vec3vf<M>& b2)
+      {
+        const float eps = 1E-5f;
+        vbool<M> valid = valid_i;
+
+        /* calculate triangle planes */
+        const Vec3vf<M> A0(a0.x,a0.y,a0.z);
+        const Vec3vf<M> A1(a1.x,a1.y,a1.z);
+        const Vec3vf<M> A2(a2.x,a2.y,a2.z);
+        const Vec3fa Na1 = cross(a1-a0,a2-a0);
+        const Vec3vf<M> Na(Na1.x,Na1.y,Na1.z);
+        const vfloat<M> Ca(dot(Na1,a0));
+        const Vec3vf<M> Nb = cross(b1-b0,b2-b0);
+        const vfloat<M> Cb = dot(Nb,b0);
+
+        /* degenerated triangles never intersect */
+        if (unlikely(dot(Na1,Na1) == 0.0f)) return false;
+        valid &= dot(Nb,Nb) > 0.0f;
+
+        /* project triangle A onto plane B */
+        const vfloat<M> da0 = dot(Nb,A0)-Cb;
+        const vfloat<M> da1 = dot(Nb,A1)-Cb;
+        const vfloat<M> da2 = dot(Nb,A2)-Cb;
+        valid &= max(max(da0,da1),da2) >= -eps;
+        valid &= min(min(da0,da1),da2) <= +eps;
+        if (none(valid)) return valid;
+
+        /* project triangles B onto plane A */
+        const vfloat<M> db0 = dot(Na,b0)-Ca;
+        const vfloat<M> db1 = dot(Na,b1)-Ca;
+        const vfloat<M> db2 = dot(Na,b2)-Ca;
+        valid &= max(max(db0,db1),db2) >= -eps;
+        valid &= min(min(db0,db1),db2) <= +eps;
+        if (none(valid)) return valid;
+
+        /* coplanar triangles require a 2D test */
+        vbool<M> hit(false);
+        const vbool<M> coplanarA = (abs(da0) < eps) & (abs(da1) < eps) & (abs(da2) < eps);
+        const vbool<M> coplanarB = (abs(db0) < eps) & (abs(db1) < eps) & (abs(db2) < eps);
+        const vbool<M> coplanar = valid & (coplanarA | coplanarB);
+        if (unlikely(any(coplanar)))
+        {
+          size_t bits = movemask(coplanar);
+          while (bits) {
+            const size_t k = bscf(bits);
+            const Vec3fa B0(b0.x[k],b0.y[k],b0.z[k]);
+            const Vec3fa B1(b1.x[k],b1.y[k],b1.z[k]);
+            const Vec3fa B2(b2.x[k],b2.y[k],b2.z[k]);
+            if (intersect_triangle_triangle(a0,a1,a2,B0,B1,B2))
+              hit |= vint<M>(step) == vint<M>(int(k));
+          }
+          valid &= !coplanar;
+        }
+
+        /* intersect the intervals along the intersection line of both planes */
+        const Vec3vf<M> D = cross(Na,Nb);
+        const vfloat<M> pa0 = dot(D,A0);
+        const vfloat<M> pa1 = dot(D,A1);
+        const vfloat<M> pa2 = dot(D,A2);
+        const vfloat<M> pb0 = dot(D,b0);
+        const vfloat<M> pb1 = dot(D,b1);
+        const vfloat<M> pb2 = dot(D,b2);
+
+        vfloat<M> ba_lower(pos_inf), ba_upper(neg_inf);
+        extend_interval<M>(pa0,pa1,da0,da1,ba_lower,ba_upper);
+        extend_interval<M>(pa1,pa2,da1,da2,ba_lower,ba_upper);
+        extend_interval<M>(pa2,pa0,da2,da0,ba_lower,ba_upper);
+
+        vfloat<M> bb_lower(pos_inf), bb_upper(neg_inf);
+        extend_interval<M>(pb0,pb1,db0,db1,bb_lower,bb_upper);
+        extend_interval<M>(pb1,pb2,db1,db2,bb_lower,bb_upper);
+        extend_interval<M>(pb2,pb0,db2,db0,bb_lower,bb_upper);
+
+        return hit | (valid & (max(ba_lower,bb_lower) <= min(ba_upper,bb_upper)));
+      }
     };
   }
 }
@@ -12,10 +12,13 @@ namespace embree
   __thread ThreadWorkState* SharedLazyTessellationCache::init_t_state = nullptr;
   ThreadWorkState* SharedLazyTessellationCache::current_t_state = nullptr;
 
-  void resizeTessellationCache(size_t new_size)
+  void resizeTessellationCache(size_t new_size, size_t max_size)
   {    
     if (new_size >= SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE)
       new_size = SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE;
+    if (max_size >= SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE)
+      max_size = SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE;
+    SharedLazyTessellationCache::sharedLazyTessellationCache.setMaxSize(max(new_size,max_size));
     if (SharedLazyTessellationCache::sharedLazyTessellationCache.getSize() != new_size) 
       SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(new_size);    
   }
@@ -29,12 +32,16 @@ namespace embree
   SharedLazyTessellationCache::SharedLazyTessellationCache()
   {
     size = 0;
+    maxSize = 0;
     data = nullptr;
     hugepages = false;
     maxBlocks              = size/BLOCK_SIZE;
     localTime              = NUM_CACHE_SEGMENTS;
     next_block             = 0;
     numRenderThreads       = 0;
+    growCheckFlushes       = 0;
+    growCheckHits          = 0;
+    growCheckMisses        = 0;
 #if FORCE_SIMPLE_FLUSH == 1
     switch_block_threshold = maxBlocks;
 #else
@@ -101,6 +108,7 @@ namespace embree
         /* switch to the next segment */
         addCurrentIndex();
         CACHE_STATS(PRINT("RESET TESS CACHE"));
+        const size_t flushes = ++SharedTessellationCacheStats::cache_flushes;
         
 #if FORCE_SIMPLE_FLUSH == 1
         next_block = 0;
@@ -111,8 +119,27 @@ namespace embree
         switch_block_threshold = next_block + (maxBlocks/NUM_CACHE_SEGMENTS);
         assert( switch_block_threshold <= maxBlocks );
 #endif
-        
-        CACHE_STATS(SharedTessellationCacheStats::cache_flushes++);
+
+        /* once all segments got recycled, grow the cache if most lookups missed since the last check */
+        if (flushes - growCheckFlushes >= NUM_CACHE_SEGMENTS)
+        {
+          size_t hits = 0, misses = 0;
+          sumStats(hits,misses);
+          const bool thrashing = misses-growCheckMisses > hits-growCheckHits;
+          growCheckFlushes = flushes;
+          growCheckHits = hits;
+          growCheckMisses = misses;
+          
+          if (thrashing && size < maxSize)
+          {
+            try {
+              reallocBlocked(min(2*size,maxSize));
+              SharedTessellationCacheStats::cache_resizes++;
+            } catch (std::bad_alloc&) {
+              maxSize = size; // do not try growing again
+            }
+          }
+        }
         
         /* release all blocked threads */
         
@@ -181,10 +208,30 @@ namespace embree
         waitForUsersLessEqual(t,THREAD_BLOCK_ATOMIC_ADD);
 
     /* reallocate data */
+    reallocBlocked(new_size);
+
+    /* release all blocked threads */
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
+      unlockThread(t,-THREAD_BLOCK_ATOMIC_ADD);
+
+    /* unlock the linked list of thread states */
+    linkedlist_mtx.unlock();	    
+
+    /* unlock the reset_state */
+    reset_state.unlock();
+  }
+
+
+  void SharedLazyTessellationCache::reallocBlocked(const size_t new_size)
+  {
+    /* allocate new memory first, to keep the old cache intact in case this fails */
+    bool new_hugepages = false;
+    float* new_data = nullptr;
+    if (new_size) new_data = (float*)os_malloc(new_size,new_hugepages);
     if (data) os_free(data,size,hugepages);
+    data      = new_data;
+    hugepages = new_hugepages;
     size      = new_size;
-    data      = nullptr;
-    if (size) data = (float*)os_malloc(size,hugepages);
     maxBlocks = size/BLOCK_SIZE;    
 
     /* invalidate entire cache */
@@ -200,6 +247,44 @@ namespace embree
     switch_block_threshold = next_block + (maxBlocks/NUM_CACHE_SEGMENTS);
     assert( switch_block_threshold <= maxBlocks );
 #endif
+  }
+
+  void SharedLazyTessellationCache::sumStats(size_t& hits, size_t& misses)
+  {
+    hits = misses = 0;
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next) {
+      hits   += t->hits.load(std::memory_order_relaxed);
+      misses += t->misses.load(std::memory_order_relaxed);
+    }
+  }
+
+  void SharedLazyTessellationCache::getStats(size_t& hits, size_t& misses)
+  {
+    linkedlist_mtx.lock();
+    sumStats(hits,misses);
+    linkedlist_mtx.unlock();
+  }
+
+  void SharedLazyTessellationCache::clearStats()
+  {
+    /* lock the reset_state */
+    reset_state.lock();
+
+    /* lock the linked list of thread states */
+    linkedlist_mtx.lock();
+
+    /* block all threads, as they write their counters without atomic read-modify-write */
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
+      if (lockThread(t,THREAD_BLOCK_ATOMIC_ADD) != 0)
+        waitForUsersLessEqual(t,THREAD_BLOCK_ATOMIC_ADD);
+
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next) {
+      t->hits = 0;
+      t->misses = 0;
+    }
+    SharedTessellationCacheStats::cache_flushes = 0;
+    SharedTessellationCacheStats::cache_resizes = 0;
+    growCheckFlushes = growCheckHits = growCheckMisses = 0;
 
     /* release all blocked threads */
     for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
@@ -212,35 +297,32 @@ namespace embree
     reset_state.unlock();
   }
 
-
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  std::atomic<size_t> SharedTessellationCacheStats::cache_accesses(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_hits(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_misses(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_flushes(0);  
+  std::atomic<size_t> SharedTessellationCacheStats::cache_flushes(0);
+  std::atomic<size_t> SharedTessellationCacheStats::cache_resizes(0);
   SpinLock   SharedTessellationCacheStats::mtx;  
   size_t SharedTessellationCacheStats::cache_num_patches(0);
 
   void SharedTessellationCacheStats::printStats()
   {
+    size_t cache_hits = 0, cache_misses = 0;
+    SharedLazyTessellationCache::sharedLazyTessellationCache.getStats(cache_hits,cache_misses);
+    const size_t cache_accesses = cache_hits + cache_misses;
     PRINT(cache_accesses);
     PRINT(cache_misses);
     PRINT(cache_hits);
     PRINT(cache_flushes);
-    PRINT(100.0f * cache_hits / cache_accesses);
-    assert(cache_hits + cache_misses == cache_accesses);
+    PRINT(cache_resizes);
+    PRINT(100.0f * cache_hits / max(cache_accesses,size_t(1)));
     PRINT(cache_num_patches);
   }
 
   void SharedTessellationCacheStats::clearStats()
   {
-    SharedTessellationCacheStats::cache_accesses  = 0;
-    SharedTessellationCacheStats::cache_hits      = 0;
-    SharedTessellationCacheStats::cache_misses    = 0;
-    SharedTessellationCacheStats::cache_flushes   = 0;
+    SharedLazyTessellationCache::sharedLazyTessellationCache.clearStats();
   }
 
   struct cache_regression_test : public RegressionTest
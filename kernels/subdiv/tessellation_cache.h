@@ -22,10 +22,8 @@ namespace embree
   {
   public:
     /* stats */
-    static std::atomic<size_t> cache_accesses;
-    static std::atomic<size_t> cache_hits;
-    static std::atomic<size_t> cache_misses;
-    static std::atomic<size_t> cache_flushes;                
+    static std::atomic<size_t> cache_flushes;
+    static std::atomic<size_t> cache_resizes;
     static size_t        cache_num_patches;
     __aligned(64) static SpinLock mtx;
     
@@ -34,7 +32,7 @@ namespace embree
     static void clearStats();
   };
   
-  void resizeTessellationCache(size_t new_size);
+  void resizeTessellationCache(size_t new_size, size_t max_size = 0);
   void resetTessellationCache();
   
  ////////////////////////////////////////////////////////////////////////////////
@@ -49,8 +47,12 @@ namespace embree
    ThreadWorkState* next;
    bool allocated;
 
+   /* cache statistics, only written by the owning thread */
+   std::atomic<size_t> hits;
+   std::atomic<size_t> misses;
+
    __forceinline ThreadWorkState(bool allocated = false) 
-     : counter(0), next(nullptr), allocated(allocated) 
+     : counter(0), next(nullptr), allocated(allocated), hits(0), misses(0)
    {
      assert( ((size_t)this % 64) == 0 ); 
    }   
@@ -130,6 +132,7 @@ namespace embree
    float *data;
    bool hugepages;
    size_t size;
+   size_t maxSize;       //!< size the cache may grow to when thrashing
    size_t maxBlocks;
    ThreadWorkState *threadWorkState;
       
@@ -140,6 +143,11 @@ namespace embree
    __aligned(64) std::atomic<size_t> switch_block_threshold;
    __aligned(64) std::atomic<size_t> numRenderThreads;
 
+   /* statistics at the last growth check */
+   size_t growCheckFlushes;
+   size_t growCheckHits;
+   size_t growCheckMisses;
+
 
  public:
 
@@ -166,6 +174,10 @@ namespace embree
 
    __forceinline bool isLocked(ThreadWorkState *const t_state) { return t_state->counter.load() != 0; }
 
+   /* per thread statistics counters, no atomic read-modify-write required as only the owning thread writes */
+   static __forceinline void countHit (ThreadWorkState *const t_state) { t_state->hits.store  (t_state->hits.load  (std::memory_order_relaxed)+1,std::memory_order_relaxed); }
+   static __forceinline void countMiss(ThreadWorkState *const t_state) { t_state->misses.store(t_state->misses.load(std::memory_order_relaxed)+1,std::memory_order_relaxed); }
+
    static __forceinline void lock  () { sharedLazyTessellationCache.lockThread(threadState()); }
    static __forceinline void unlock() { sharedLazyTessellationCache.unlockThread(threadState()); }
    static __forceinline bool isLocked() { return sharedLazyTessellationCache.isLocked(threadState()); }
@@ -196,7 +208,6 @@ namespace embree
    static __forceinline void* lookup(CacheEntry& entry, size_t globalTime)
    {   
      const int64_t subdiv_patch_root_ref = entry.tag.get(); 
-     CACHE_STATS(SharedTessellationCacheStats::cache_accesses++);
      
      if (likely(subdiv_patch_root_ref != 0)) 
      {
@@ -204,12 +215,8 @@ namespace embree
        const size_t subdiv_patch_cache_index = extractCommitIndex(subdiv_patch_root_ref);
        
        if (likely( sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index,globalTime) ))
-       {
-         CACHE_STATS(SharedTessellationCacheStats::cache_hits++);
          return (void*) subdiv_patch_root;
-       }
      }
-     CACHE_STATS(SharedTessellationCacheStats::cache_misses++);
      return nullptr;
    }
 
@@ -222,12 +229,16 @@ namespace embree
      {
        sharedLazyTessellationCache.lockThreadLoop(t_state);
        void* patch = SharedLazyTessellationCache::lookup(entry,globalTime);
-       if (patch) return (decltype(constructor())) patch;
+       if (patch) {
+         countHit(t_state);
+         return (decltype(constructor())) patch;
+       }
        
        if (entry.mutex.try_lock())
        {
          if (!validTag(entry.tag,globalTime)) 
          {
+           countMiss(t_state);
            auto timeBefore = sharedLazyTessellationCache.getTime(globalTime);
            auto ret = constructor(); // thread is locked here!
            assert(ret);
@@ -314,12 +325,30 @@ namespace embree
    __forceinline size_t getNumUsedBytes() { return next_block * BLOCK_SIZE; }
    __forceinline size_t getMaxBlocks()    { return maxBlocks; }
    __forceinline size_t getSize()         { return size; }
+   __forceinline size_t getMaxSize()      { return maxSize; }
+   __forceinline void   setMaxSize(const size_t bytes) { maxSize = bytes; }
 
    void allocNextSegment();
    void realloc(const size_t newSize);
 
    void reset();
 
+   /*! sums up the hit and miss counters of all threads */
+   void getStats(size_t& hits, size_t& misses);
+
+   /*! clears all statistics counters */
+   void clearStats();
+
+ private:
+
+   /*! reallocates the cache memory, requires all threads to be blocked */
+   void reallocBlocked(const size_t newSize);
+
+   /*! sums up hit and miss counters, requires linked list of thread states to be locked */
+   void sumStats(size_t& hits, size_t& misses);
+
+ public:
+
    static SharedLazyTessellationCache sharedLazyTessellationCache;
  };
 }
@@ -76,6 +76,12 @@ namespace embree
       if (buildParams.buildBenchType & BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC) {
         Benchmark_Static_Create(state, params, buildParams, tutorial->ispc_scene.get(), RTC_BUILD_QUALITY_MEDIUM,RTC_BUILD_QUALITY_HIGH);
       }
+      if (buildParams.buildBenchType & BuildBenchType::CREATE_LBVH_STATIC_STATIC) {
+        Benchmark_Static_Create_Builder(state, params, buildParams, tutorial->ispc_scene.get(), tutorial->rtcore, "lbvh");
+      }
+      if (buildParams.buildBenchType & BuildBenchType::CREATE_TRBVH_STATIC_STATIC) {
+        Benchmark_Static_Create_Builder(state, params, buildParams, tutorial->ispc_scene.get(), tutorial->rtcore, "trbvh");
+      }
     }
     else
     {
@@ -18,6 +18,7 @@ namespace embree {
   void Benchmark_Dynamic_Create(BenchState& state, BenchParams& params, BuildBenchParams& buildParams, ISPCScene* ispc_scene, RTCBuildQuality quality);
   void Benchmark_Static_Create(BenchState& state, BenchParams& params, BuildBenchParams& buildParams, ISPCScene* ispc_scene, RTCBuildQuality quality, RTCBuildQuality qflags);
   void Benchmark_Static_Create_UserThreads(BenchState& state, BenchParams& params, BuildBenchParams& buildParams, ISPCScene* ispc_scene, RTCBuildQuality quality, RTCBuildQuality qflags);
+  void Benchmark_Static_Create_Builder(BenchState& state, BenchParams& params, BuildBenchParams& buildParams, ISPCScene* ispc_scene, const std::string& rtcore, const std::string& builder);
 
   size_t getNumPrimitives(ISPCScene* scene_in);
 }
\ No newline at end of file
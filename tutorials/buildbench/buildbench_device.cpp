@@ -463,6 +463,22 @@ namespace embree {
     Benchmark_Static_Create_Legacy(ispc_scene, params, quality, qflags);
 #endif
   }
+  void Benchmark_Static_Create_Builder(
+    BenchState& state,
+    BenchParams& params,
+    BuildBenchParams& buildParams,
+    ISPCScene* ispc_scene,
+    const std::string& rtcore,
+    const std::string& builder)
+  {
+    /* the triangle builder is selected by the device configuration, thus build on a separate device */
+    RTCDevice device = rtcNewDevice((rtcore+",tri_builder="+builder).c_str());
+    std::swap(g_device,device);
+    Benchmark_Static_Create(state, params, buildParams, ispc_scene, RTC_BUILD_QUALITY_MEDIUM, RTC_BUILD_QUALITY_MEDIUM);
+    std::swap(g_device,device);
+    rtcReleaseDevice(device);
+  }
+
   struct Helper {
     BarrierSys barrier;
     volatile bool term = false;
@@ -39,6 +39,9 @@
       : org(org,tnear), dir(dir,time), tfar(tfar), mask(mask), primID(primID), geomID(geomID)
     {
       instID[0] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      instPrimID[0] = RTC_INVALID_GEOMETRY_ID;
+#endif
     }
 
     /*! Tests if we hit something. */
@@ -61,6 +64,9 @@
     unsigned int primID;           //!< primitive ID
     unsigned int geomID;           //!< geometry ID
     unsigned int instID[RTC_MAX_INSTANCE_LEVEL_COUNT];           //!< instance ID
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    unsigned int instPrimID[RTC_MAX_INSTANCE_LEVEL_COUNT];       //!< instance primitive ID
+#endif
 
     __forceinline float &tnear() { return org.w; };
     __forceinline float &time()  { return dir.w; };
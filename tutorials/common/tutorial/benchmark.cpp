@@ -243,6 +243,8 @@ void TutorialBuildBenchmark::registerBenchmark(std::string const& name, int argc
   registerBuildBenchmark(name, BuildBenchType::CREATE_STATIC_STATIC,              argc, argv);
   registerBuildBenchmark(name, BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC, argc, argv);
   registerBuildBenchmark(name, BuildBenchType::CREATE_USER_THREADS_STATIC_STATIC, argc, argv);
+  registerBuildBenchmark(name, BuildBenchType::CREATE_LBVH_STATIC_STATIC,         argc, argv);
+  registerBuildBenchmark(name, BuildBenchType::CREATE_TRBVH_STATIC_STATIC,        argc, argv);
 }
 
 void TutorialBuildBenchmark::postParseCommandLine()
@@ -22,7 +22,9 @@ enum BuildBenchType {
   CREATE_STATIC_STATIC = 64,
   CREATE_HIGH_QUALITY_STATIC_STATIC = 128,
   CREATE_USER_THREADS_STATIC_STATIC = 256,
-  ALL = 511
+  CREATE_LBVH_STATIC_STATIC = 512,
+  CREATE_TRBVH_STATIC_STATIC = 1024,
+  ALL = 2047
 };
 
 static MAYBE_UNUSED BuildBenchType getBuildBenchType(std::string const& str)
@@ -36,6 +38,8 @@ static MAYBE_UNUSED BuildBenchType getBuildBenchType(std::string const& str)
   else if (str == "create_static_static")              return BuildBenchType::CREATE_STATIC_STATIC;
   else if (str == "create_high_quality_static_static") return BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC;
   else if (str == "create_user_threads_static_static") return BuildBenchType::CREATE_USER_THREADS_STATIC_STATIC;
+  else if (str == "create_lbvh_static_static")         return BuildBenchType::CREATE_LBVH_STATIC_STATIC;
+  else if (str == "create_trbvh_static_static")        return BuildBenchType::CREATE_TRBVH_STATIC_STATIC;
   return BuildBenchType::ALL;
 }
 
@@ -50,6 +54,8 @@ static MAYBE_UNUSED std::string getBuildBenchTypeString(BuildBenchType type)
   else if (type == BuildBenchType::CREATE_STATIC_STATIC)              return "create_static_static";
   else if (type == BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC) return "create_high_quality_static_static";
   else if (type == BuildBenchType::CREATE_USER_THREADS_STATIC_STATIC) return "create_user_threads_static_static";
+  else if (type == BuildBenchType::CREATE_LBVH_STATIC_STATIC)         return "create_lbvh_static_static";
+  else if (type == BuildBenchType::CREATE_TRBVH_STATIC_STATIC)        return "create_trbvh_static_static";
   return "all";
 }
 
@@ -17,12 +17,14 @@ namespace embree
   #define MULTI_PASS_FIXED_NEXT_HITS 1
   #define MULTI_PASS_OPTIMAL_NEXT_HITS 2
   #define MULTI_PASS_ESTIMATED_NEXT_HITS 3
+  #define NATIVE_MULTI_HIT 4
 
   const char* next_hit_mode_names[] = {
     "single pass",
     "multi_pass_fixed_next_hits",
     "multi_pass_optimal_next_hits",
-    "multi_pass_estimated_next_hits"
+    "multi_pass_estimated_next_hits",
+    "native_multi_hit"
   };
   
   extern "C" {
@@ -56,6 +58,12 @@ namespace embree
           g_next_hit_mode = MULTI_PASS_ESTIMATED_NEXT_HITS;
         }, "--multi_pass_estimate_next_hits: use multiple passes and estimate the number of hits to gather from opacity");
 
+#if !defined(EMBREE_SYCL_TUTORIAL)
+      registerOption("native_multi_hit", [] (Ref<ParseStream> cin, const FileName& path) {
+          g_next_hit_mode = NATIVE_MULTI_HIT;
+        }, "--native_multi_hit: gather the max_total_hits closest hits in a single traversal using a multi-hit query (ignores curve opacity)");
+#endif
+
       registerOption("max_next_hits", [] (Ref<ParseStream> cin, const FileName& path) {
           g_max_next_hits = cin->getInt();
         }, "--max_next_hits <int>: sets maximal number of hits to accumulate in each pass");
@@ -94,7 +102,7 @@ namespace embree
     void drawGUI() override
     {
       
-      ImGui::Combo("mode",&g_next_hit_mode,next_hit_mode_names,4);
+      ImGui::Combo("mode",&g_next_hit_mode,next_hit_mode_names,5);
       if (g_next_hit_mode != 0)
         ImGui::DragInt("max_next_hits",(int*)&g_max_next_hits,1.0f,1,16);
       ImGui::DragInt("max_total_hits",(int*)&g_max_total_hits,1.0f,1,128);
@@ -8,6 +8,7 @@
 #define MULTI_PASS_FIXED_NEXT_HITS 1
 #define MULTI_PASS_OPTIMAL_NEXT_HITS 2
 #define MULTI_PASS_ESTIMATED_NEXT_HITS 3
+#define NATIVE_MULTI_HIT 4
 
 namespace embree {
 
@@ -301,6 +302,35 @@ void multi_pass(const TutorialData& data, const Ray& ray_i, HitList& hits_o, int
   context.hits.begin = 0;
 }
 
+#if !defined(EMBREE_SYCL_TUTORIAL)
+
+/* gathers the closest hits in a single traversal using the multi-hit buffer of the intersection arguments */
+void native_multi_hit(const TutorialData& data, const Ray& ray_i, HitList& hits_o, RayStats& stats, const RTCFeatureFlags feature_mask)
+{
+  float t[MAX_TOTAL_HITS];
+  RTCHit hits[MAX_TOTAL_HITS];
+  RTCMultiHit multiHit;
+  multiHit.maxHits = std::min(data.max_total_hits,(unsigned)MAX_TOTAL_HITS);
+  multiHit.numHits = 0;
+  multiHit.t = t;
+  multiHit.hits = hits;
+
+  Ray ray = ray_i;
+  RTCIntersectArguments args;
+  rtcInitIntersectArguments(&args);
+  args.feature_mask = feature_mask;
+  args.multiHit = &multiHit;
+  rtcIntersect1(data.scene,RTCRayHit_(ray),&args);
+  RayStats_addRay(stats);
+
+  /* hits at equal distance are sorted by the extended order used by the other modes */
+  for (unsigned int i=0; i<multiHit.numHits; i++)
+    hits_o.hits[hits_o.end++] = HitList::Hit(false,t[i],hits[i].primID,hits[i].geomID,hits[i].instID[0]);
+  insertionsort_ascending(&hits_o.hits[hits_o.begin], hits_o.size());
+}
+
+#endif
+
 /* task that renders a single screen tile */
 Vec3ff renderPixelStandard(const TutorialData& data, float x, float y,
                            const unsigned int width,
@@ -340,6 +370,9 @@ Vec3ff renderPixelStandard(const TutorialData& data, float x, float y,
     multi_pass (data,ray,hits,estimated_num_next_hits,mysampler,stats,feature_mask);
     break;
   }
+  case NATIVE_MULTI_HIT:
+    native_multi_hit(data,ray,hits,stats,feature_mask);
+    break;
 #endif
   default:
     assert(false);
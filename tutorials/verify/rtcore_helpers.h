@@ -137,6 +137,10 @@ namespace embree
     rh.hit.primID = -1;
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       rh.hit.instID[l] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      rh.hit.instPrimID[l] = RTC_INVALID_GEOMETRY_ID;
+#endif
   }
 
   __forceinline RTCRayHit makeRay(const Vec3fa& org, const Vec3fa& dir) 
@@ -149,6 +153,10 @@ namespace embree
     rh.hit.geomID = rh.hit.primID = -1;
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       rh.hit.instID[l] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      rh.hit.instPrimID[l] = RTC_INVALID_GEOMETRY_ID;
+#endif
     return rh;
   }
 
@@ -162,6 +170,10 @@ namespace embree
     rh.hit.geomID = rh.hit.primID = -1;
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       rh.hit.instID[l] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      rh.hit.instPrimID[l] = RTC_INVALID_GEOMETRY_ID;
+#endif
     return rh;
   }
 
@@ -178,6 +190,10 @@ namespace embree
     rh.hit.geomID = rh.hit.primID = -1;
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       rh.hit.instID[l] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      rh.hit.instPrimID[l] = RTC_INVALID_GEOMETRY_ID;
+#endif
     return rh;
   }
 
@@ -196,6 +212,9 @@ namespace embree
     rh.ray.mask = -1;
     rh.ray.id = -1;
     rh.hit.geomID = rh.hit.primID = rh.hit.instID[0] = -1;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    rh.hit.instPrimID[0] = -1;
+#endif
   }
 
   __forceinline void fastMakeRay(RTCRayHit& ray, const Vec3fa& org, RandomSampler& sampler)
@@ -213,6 +232,10 @@ namespace embree
     rh.hit.geomID = rh.hit.primID = -1;
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       rh.hit.instID[l] = RTC_INVALID_GEOMETRY_ID;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      rh.hit.instPrimID[l] = RTC_INVALID_GEOMETRY_ID;
+#endif
     return rh;
   }
 
@@ -232,6 +255,9 @@ namespace embree
     if (*(int*)&ray0.hit.u      != *(int*)&ray1.hit.u     ) return true;
     if (*(int*)&ray0.hit.v      != *(int*)&ray1.hit.v     ) return true;
     if (*(int*)&ray0.hit.instID != *(int*)&ray1.hit.instID) return true;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    if (*(int*)&ray0.hit.instPrimID != *(int*)&ray1.hit.instPrimID) return true;
+#endif
     if (*(int*)&ray0.hit.geomID != *(int*)&ray1.hit.geomID) return true;
     if (*(int*)&ray0.hit.primID != *(int*)&ray1.hit.primID) return true;
     if (*(int*)&ray0.hit.Ng_x  != *(int*)&ray1.hit.Ng_x ) return true;
@@ -291,6 +317,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       ray_o.hit.instID[l][i] = ray_i.hit.instID[l];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      ray_o.hit.instPrimID[l][i] = ray_i.hit.instPrimID[l];
+#endif
   }
 
   __forceinline void setRay(RTCRayHit8& ray_o, size_t i, const RTCRayHit& ray_i)
@@ -316,6 +346,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       ray_o.hit.instID[l][i] = ray_i.hit.instID[l];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      ray_o.hit.instPrimID[l][i] = ray_i.hit.instPrimID[l];
+#endif
   }
 
   __forceinline void setRay(RTCRayHit16& ray_o, size_t i, const RTCRayHit& ray_i)
@@ -341,6 +375,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       ray_o.hit.instID[l][i] = ray_i.hit.instID[l];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      ray_o.hit.instPrimID[l][i] = ray_i.hit.instPrimID[l];
+#endif
   }
 
   __forceinline void setRay(RTCRayHitN* rayhit_o, unsigned int N, unsigned int i, const RTCRayHit& ray_i)
@@ -368,6 +406,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       RTCHitN_instID(hit_o,N,i,l) = ray_i.hit.instID[l];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      RTCHitN_instPrimID(hit_o,N,i,l) = ray_i.hit.instPrimID[l];
+#endif
   }
 
   __forceinline RTCRayHit getRay(RTCRayHit4& ray_i, size_t i)
@@ -394,6 +436,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       ray_o.hit.instID[l] = ray_i.hit.instID[l][i];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      ray_o.hit.instPrimID[l] = ray_i.hit.instPrimID[l][i];
+#endif
 
     return ray_o;
   }
@@ -422,6 +468,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       ray_o.hit.instID[l] = ray_i.hit.instID[l][i];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      ray_o.hit.instPrimID[l] = ray_i.hit.instPrimID[l][i];
+#endif
 
     return ray_o;
   }
@@ -450,6 +500,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       ray_o.hit.instID[l] = ray_i.hit.instID[l][i];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      ray_o.hit.instPrimID[l] = ray_i.hit.instPrimID[l][i];
+#endif
     return ray_o;
   }
 
@@ -479,6 +533,10 @@ namespace embree
 
     for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
       ray_o.hit.instID[l] = RTCHitN_instID(hit_i, N, i, l);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+    for (unsigned l = 0; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
+      ray_o.hit.instPrimID[l] = RTCHitN_instPrimID(hit_i, N, i, l);
+#endif
 
     return ray_o;
   }
@@ -489,7 +547,9 @@ namespace embree
     MODE_INTERSECT1,
     MODE_INTERSECT4,
     MODE_INTERSECT8,
-    MODE_INTERSECT16
+    MODE_INTERSECT16,
+    MODE_INTERSECT1M,
+    MODE_INTERSECTNp
   };
 
   inline std::string to_string(IntersectMode imode)
@@ -500,6 +560,8 @@ namespace embree
     case MODE_INTERSECT4: return "4";
     case MODE_INTERSECT8: return "8";
     case MODE_INTERSECT16: return "16";
+    case MODE_INTERSECT1M: return "1M";
+    case MODE_INTERSECTNp: return "Np";
     default                : return "U";
     }
   }
@@ -512,6 +574,8 @@ namespace embree
     case MODE_INTERSECT4: return 16;
     case MODE_INTERSECT8: return 32;
     case MODE_INTERSECT16: return 64;
+    case MODE_INTERSECT1M: return 16;
+    case MODE_INTERSECTNp: return 16;
     default              : return 0;
     }
   }
@@ -555,6 +619,8 @@ namespace embree
     case MODE_INTERSECT4:
     case MODE_INTERSECT8:
     case MODE_INTERSECT16:
+    case MODE_INTERSECT1M:
+    case MODE_INTERSECTNp:
       switch (ivariant) {
       case VARIANT_INTERSECT: return true;
       case VARIANT_OCCLUDED : return true;
@@ -573,6 +639,8 @@ namespace embree
     case MODE_INTERSECT4:
     case MODE_INTERSECT8:
     case MODE_INTERSECT16:
+    case MODE_INTERSECT1M:
+    case MODE_INTERSECTNp:
       switch (ivariant) {
       case VARIANT_INTERSECT: return "Intersect" + to_string(imode);
       case VARIANT_OCCLUDED : return "Occluded" + to_string(imode);
@@ -713,6 +781,68 @@ namespace embree
       }
       break;
     }
+    case MODE_INTERSECT1M: 
+    {
+      switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+      case VARIANT_INTERSECT: rtcIntersect1M(scene,rays,N,sizeof(RTCRayHit),args); break;
+      case VARIANT_OCCLUDED : rtcOccluded1M (scene,(RTCRay*)rays,N,sizeof(RTCRayHit),(RTCOccludedArguments*)args); break;
+      default: assert(false);
+      }
+      break;
+    }
+    case MODE_INTERSECTNp: 
+    {
+      vector_t<float,aligned_allocator<float,16>> data(19*N);
+      RTCRayHitNp rayhitNp;
+      float* p = data.data();
+      rayhitNp.ray.org_x = p; p += N; rayhitNp.ray.org_y = p; p += N; rayhitNp.ray.org_z = p; p += N; rayhitNp.ray.tnear = p; p += N;
+      rayhitNp.ray.dir_x = p; p += N; rayhitNp.ray.dir_y = p; p += N; rayhitNp.ray.dir_z = p; p += N; rayhitNp.ray.time  = p; p += N;
+      rayhitNp.ray.tfar  = p; p += N; rayhitNp.ray.mask  = (unsigned*)p; p += N; rayhitNp.ray.id = (unsigned*)p; p += N; rayhitNp.ray.flags = (unsigned*)p; p += N;
+      rayhitNp.hit.Ng_x  = p; p += N; rayhitNp.hit.Ng_y  = p; p += N; rayhitNp.hit.Ng_z = p; p += N;
+      rayhitNp.hit.u     = p; p += N; rayhitNp.hit.v     = p; p += N;
+      rayhitNp.hit.primID = (unsigned*)p; p += N; rayhitNp.hit.geomID = (unsigned*)p; p += N;
+      vector_t<unsigned,aligned_allocator<unsigned,16>> instID(N*RTC_MAX_INSTANCE_LEVEL_COUNT);
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++) rayhitNp.hit.instID[l] = instID.data()+l*N;
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+      vector_t<unsigned,aligned_allocator<unsigned,16>> instPrimID(N*RTC_MAX_INSTANCE_LEVEL_COUNT);
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++) rayhitNp.hit.instPrimID[l] = instPrimID.data()+l*N;
+#endif
+
+      for (size_t i=0; i<N; i++)
+      {
+        const RTCRayHit& r = rays[i];
+        rayhitNp.ray.org_x[i] = r.ray.org_x; rayhitNp.ray.org_y[i] = r.ray.org_y; rayhitNp.ray.org_z[i] = r.ray.org_z; rayhitNp.ray.tnear[i] = r.ray.tnear;
+        rayhitNp.ray.dir_x[i] = r.ray.dir_x; rayhitNp.ray.dir_y[i] = r.ray.dir_y; rayhitNp.ray.dir_z[i] = r.ray.dir_z; rayhitNp.ray.time[i]  = r.ray.time;
+        rayhitNp.ray.tfar[i]  = r.ray.tfar;  rayhitNp.ray.mask[i]  = r.ray.mask;  rayhitNp.ray.id[i]    = r.ray.id;    rayhitNp.ray.flags[i] = r.ray.flags;
+        rayhitNp.hit.Ng_x[i]  = r.hit.Ng_x;  rayhitNp.hit.Ng_y[i]  = r.hit.Ng_y;  rayhitNp.hit.Ng_z[i]  = r.hit.Ng_z;
+        rayhitNp.hit.u[i]     = r.hit.u;     rayhitNp.hit.v[i]     = r.hit.v;
+        rayhitNp.hit.primID[i] = r.hit.primID; rayhitNp.hit.geomID[i] = r.hit.geomID;
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++) rayhitNp.hit.instID[l][i] = r.hit.instID[l];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++) rayhitNp.hit.instPrimID[l][i] = r.hit.instPrimID[l];
+#endif
+      }
+
+      switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+      case VARIANT_INTERSECT: rtcIntersectNp(scene,&rayhitNp,N,args); break;
+      case VARIANT_OCCLUDED : rtcOccludedNp (scene,&rayhitNp.ray,N,(RTCOccludedArguments*)args); break;
+      default: assert(false);
+      }
+
+      for (size_t i=0; i<N; i++)
+      {
+        RTCRayHit& r = rays[i];
+        r.ray.tfar = rayhitNp.ray.tfar[i];
+        r.hit.Ng_x = rayhitNp.hit.Ng_x[i]; r.hit.Ng_y = rayhitNp.hit.Ng_y[i]; r.hit.Ng_z = rayhitNp.hit.Ng_z[i];
+        r.hit.u = rayhitNp.hit.u[i]; r.hit.v = rayhitNp.hit.v[i];
+        r.hit.primID = rayhitNp.hit.primID[i]; r.hit.geomID = rayhitNp.hit.geomID[i];
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++) r.hit.instID[l] = rayhitNp.hit.instID[l][i];
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++) r.hit.instPrimID[l] = rayhitNp.hit.instPrimID[l][i];
+#endif
+      }
+      break;
+    }
     }
   }
 
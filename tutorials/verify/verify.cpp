@@ -1206,6 +1206,433 @@ namespace embree
     }
   };
 
+  struct CommitSceneAsyncTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    CommitSceneAsyncTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    static void commitFunc(void* userPtr, RTCError error) {
+      ((std::atomic<size_t>*)userPtr)->fetch_add(1);
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(zero,1.0f,200);
+      std::atomic<size_t> numCallbacks(0);
+
+      /* an asynchronous commit has to produce the same BVH as a blocking commit */
+      VerifyScene scene0(device,sflags);
+      scene0.addGeometry(quality,node);
+      rtcCommitScene (scene0);
+      AssertNoError(device);
+
+      VerifyScene scene1(device,sflags);
+      scene1.addGeometry(quality,node);
+      RTCSceneCommit commit1 = rtcCommitSceneAsync(scene1,commitFunc,&numCallbacks);
+      AssertNoError(device);
+      while (!rtcIsSceneCommitDone(commit1)) yield();
+      RTCError error1 = rtcWaitSceneCommit(commit1);
+      rtcReleaseSceneCommit(commit1);
+      AssertNoError(device);
+      if (error1 != RTC_ERROR_NONE || numCallbacks != 1)
+        return VerifyApplication::FAILED;
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 4.0f*random_Vec3fa()-Vec3fa(2.0f);
+        const Vec3fa dir = normalize(random_Vec3fa()-Vec3fa(0.5f)-org);
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* a cancelled commit either fails with RTC_ERROR_CANCELLED or finished before, afterwards the scene can get committed again */
+      VerifyScene scene2(device,sflags);
+      scene2.addGeometry(quality,node);
+      RTCSceneCommit commit2 = rtcCommitSceneAsync(scene2,commitFunc,&numCallbacks);
+      rtcCancelSceneCommit(commit2);
+      RTCError error2 = rtcWaitSceneCommit(commit2);
+      rtcReleaseSceneCommit(commit2);
+      if ((error2 != RTC_ERROR_NONE && error2 != RTC_ERROR_CANCELLED) || numCallbacks != 2)
+        return VerifyApplication::FAILED;
+
+      rtcCommitScene (scene2);
+      AssertNoError(device);
+      RTCRayHit ray = makeRay(Vec3fa(0,0,-4),Vec3fa(0,0,1));
+      rtcIntersect1(scene2,&ray);
+      if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID)
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BVHReorderTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    BVHReorderTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg0 = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg1 = cfg0 + ",bvh_reorder=1";
+      RTCDeviceRef device0 = rtcNewDevice(cfg0.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg1.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      /* the reordered BVH has to produce the same hits as the BVH in build order */
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      for (size_t i=0; i<3; i++) {
+        Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(Vec3fa(float(i)-1.0f,0.0f,0.0f),0.6f,100);
+        scene0.addGeometry(quality,node);
+        scene1.addGeometry(quality,node);
+      }
+      Ref<SceneGraph::Node> quads = SceneGraph::createQuadSphere(Vec3fa(0.0f,1.0f,0.0f),0.6f,100);
+      scene0.addGeometry(quality,quads);
+      scene1.addGeometry(quality,quads);
+      Ref<SceneGraph::Node> grids = SceneGraph::createGridSphere(Vec3fa(0.0f,-1.0f,0.0f),0.6f,20);
+      scene0.addGeometry(quality,grids);
+      scene1.addGeometry(quality,grids);
+      rtcCommitScene (scene0);
+      AssertNoError(device0);
+      rtcCommitScene (scene1);
+      AssertNoError(device1);
+
+      for (size_t i=0; i<10000; i++)
+      {
+        const Vec3fa org = 4.0f*random_Vec3fa()-Vec3fa(2.0f);
+        const Vec3fa dir = normalize(random_Vec3fa()-Vec3fa(0.5f));
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BVHCollapseTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    std::string cfg;
+
+    BVHCollapseTest (std::string name, int isa, SceneFlags sflags, std::string cfg)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), cfg(cfg) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg0 = state->rtcore + ",isa="+stringOfISA(isa) + cfg;
+      RTCDeviceRef device = rtcNewDevice(cfg0.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* the high quality BVH collapsed from a binary BVH has to find the same hits as the medium quality BVH */
+      VerifyScene scene0(device,sflags);
+      VerifyScene scene1(device,sflags);
+      rtcSetSceneBuildQuality(scene1,RTC_BUILD_QUALITY_HIGH);
+      for (size_t i=0; i<3; i++) {
+        Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(Vec3fa(2.0f*float(i)-2.0f,0.0f,0.0f),0.8f,100);
+        scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+        scene1.addGeometry(RTC_BUILD_QUALITY_HIGH,node);
+      }
+      Ref<SceneGraph::Node> quads = SceneGraph::createQuadSphere(Vec3fa(0.0f,2.0f,0.0f),0.8f,100);
+      scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,quads);
+      scene1.addGeometry(RTC_BUILD_QUALITY_HIGH,quads);
+      rtcCommitScene (scene0);
+      rtcCommitScene (scene1);
+      AssertNoError(device);
+
+      for (size_t i=0; i<10000; i++)
+      {
+        const Vec3fa org = 8.0f*random_Vec3fa()-Vec3fa(4.0f);
+        const Vec3fa dir = normalize(random_Vec3fa()-Vec3fa(0.5f));
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID)
+          return VerifyApplication::FAILED;
+        if (ray0.hit.geomID != RTC_INVALID_GEOMETRY_ID && abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f*max(1.0f,ray0.ray.tfar))
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TriangleBuilderTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    std::string builder;
+    size_t N;
+
+    TriangleBuilderTest (std::string name, int isa, SceneFlags sflags, std::string builder, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), builder(builder), N(N) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg0 = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg1 = cfg0 + ",tri_builder="+builder;
+      RTCDeviceRef device0 = rtcNewDevice(cfg0.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg1.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      /* the BVH of the tested builder has to find the same hits as the SAH BVH */
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      for (size_t i=0; i<N; i++) {
+        Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(4.0f*random_Vec3fa()-Vec3fa(2.0f),0.5f,1+RandomSampler_getInt(sampler)%100);
+        scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+        scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+      }
+      rtcCommitScene (scene0);
+      AssertNoError(device0);
+      rtcCommitScene (scene1);
+      AssertNoError(device1);
+
+      for (size_t i=0; i<10000; i++)
+      {
+        const Vec3fa org = 8.0f*random_Vec3fa()-Vec3fa(4.0f);
+        const Vec3fa dir = normalize(random_Vec3fa()-Vec3fa(0.5f));
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID && ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+        if (ray0.hit.geomID != RTC_INVALID_GEOMETRY_ID && abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f*max(1.0f,ray0.ray.tfar))
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SaveLoadBVHTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    SaveLoadBVHTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const Vec3fa center = zero;
+      const float radius = 1.0f;
+      const Vec3fa dx(1,0,0);
+      const Vec3fa dy(0,1,0);
+      std::vector<Ref<SceneGraph::Node>> nodes;
+      nodes.push_back(SceneGraph::createTriangleSphere(center,radius,50));
+      nodes.push_back(SceneGraph::createTriangleSphere(center,radius,50)->set_motion_vector(random_motion_vector(1.0f)));
+      nodes.push_back(SceneGraph::createQuadSphere(center,radius,50));
+      nodes.push_back(SceneGraph::createGridSphere(center,radius,50));
+      nodes.push_back(SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),center,dx,dy,0.1f,0.01f,100,SceneGraph::FLAT_CURVE));
+
+      VerifyScene scene0(device,sflags);
+      for (auto& node : nodes) scene0.addGeometry(quality,node);
+      rtcCommitScene (scene0);
+      AssertNoError(device);
+
+      const std::string filename = "verify_save_load_bvh_" + stringOfISA(isa) + ".bin";
+      rtcSaveSceneBVH(scene0,filename.c_str());
+      AssertNoError(device);
+
+      /* the stored BVH has to get accepted for a scene with identical geometries */
+      VerifyScene scene1(device,sflags);
+      for (auto& node : nodes) scene1.addGeometry(quality,node);
+      bool loaded = rtcLoadSceneBVH(scene1,filename.c_str());
+      AssertNoError(device);
+
+      /* the stored BVH has to get rejected if the scene layout changed */
+      VerifyScene scene2(device,sflags);
+      for (size_t i=1; i<nodes.size(); i++) scene2.addGeometry(quality,nodes[i]);
+      bool rejected = !rtcLoadSceneBVH(scene2,filename.c_str());
+      AssertNoError(device);
+      remove(filename.c_str());
+
+      if (!loaded || !rejected)
+        return VerifyApplication::FAILED;
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 4.0f*random_Vec3fa()-Vec3fa(2.0f);
+        const Vec3fa dir = normalize(center+random_Vec3fa()-Vec3fa(0.5f)-org);
+        RTCRayHit ray0 = makeRay(org,dir); ray0.ray.time = RandomSampler_getFloat(sampler);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MemoryBudgetTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    MemoryBudgetTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    static size_t totalBytes(RTCScene scene)
+    {
+      RTCSceneMemoryStatistics stats[16];
+      const size_t num = rtcGetSceneMemoryStatistics(scene,stats,16);
+      size_t bytes = 0;
+      for (size_t i=0; i<min(num,size_t(16)); i++) {
+        if (stats[i].nodeBytes == 0 || stats[i].leafBytes == 0) return 0;
+        bytes += stats[i].nodeBytes + stats[i].leafBytes + stats[i].freeBytes + stats[i].wastedBytes;
+      }
+      return bytes;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(zero,1.0f,200);
+
+      VerifyScene scene0(device,sflags);
+      scene0.addGeometry(quality,node);
+      rtcCommitScene (scene0);
+      AssertNoError(device);
+      const size_t bytes0 = totalBytes(scene0);
+      AssertNoError(device);
+      if (bytes0 == 0) return VerifyApplication::FAILED;
+
+      /* exceeding the budget has to fall back to compact acceleration structures */
+      VerifyScene scene1(device,sflags);
+      scene1.addGeometry(quality,node);
+      rtcSetSceneMemoryBudget(scene1,bytes0*3/4);
+      rtcCommitScene (scene1);
+      AssertNoError(device);
+      const size_t bytes1 = totalBytes(scene1);
+      AssertNoError(device);
+      if (!(rtcGetSceneFlags(scene1) & RTC_SCENE_FLAG_COMPACT) || bytes1 == 0 || bytes1 > bytes0*3/4)
+        return VerifyApplication::FAILED;
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 4.0f*random_Vec3fa()-Vec3fa(2.0f);
+        const Vec3fa dir = normalize(random_Vec3fa()-Vec3fa(0.5f)-org);
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* a budget too small for the compact acceleration structures has to fail */
+      VerifyScene scene2(device,sflags);
+      scene2.addGeometry(quality,node);
+      rtcSetSceneMemoryBudget(scene2,4096);
+      rtcCommitScene (scene2);
+      if (rtcGetDeviceError(device) != RTC_ERROR_OUT_OF_MEMORY)
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct AllocRetentionTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    std::string cfg;
+
+    AllocRetentionTest (std::string name, int isa, SceneFlags sflags, std::string cfg)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), cfg(cfg) {}
+
+    static void setSphere(RTCGeometry geom, const Ref<SceneGraph::TriangleMeshNode>& mesh)
+    {
+      rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,mesh->triangles.data(),0,sizeof(SceneGraph::TriangleMeshNode::Triangle),mesh->triangles.size());
+      rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,mesh->positions[0].data(),0,sizeof(SceneGraph::TriangleMeshNode::Vertex),mesh->positions[0].size());
+      rtcCommitGeometry(geom);
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg0 = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg1 = cfg0 + cfg;
+      RTCDeviceRef device0 = rtcNewDevice(cfg0.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg1.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      RTCGeometry geom0 = rtcNewGeometry(device0,RTC_GEOMETRY_TYPE_TRIANGLE);
+      RTCGeometry geom1 = rtcNewGeometry(device1,RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryBuildQuality(geom0,sflags.qflags);
+      rtcSetGeometryBuildQuality(geom1,sflags.qflags);
+      rtcAttachGeometry(scene0,geom0);
+      rtcAttachGeometry(scene1,geom1);
+      rtcReleaseGeometry(geom0);
+      rtcReleaseGeometry(geom1);
+
+      /* rebuilds with growing, equal and shrinking geometry have to produce the same hits as without block retention */
+      const unsigned int numPhi[] = { 40, 80, 80, 20, 80, 40 };
+      for (size_t i=0; i<sizeof(numPhi)/sizeof(numPhi[0]); i++)
+      {
+        Ref<SceneGraph::TriangleMeshNode> mesh = SceneGraph::createTriangleSphere(Vec3fa(0.1f*float(i)),1.0f,numPhi[i]).dynamicCast<SceneGraph::TriangleMeshNode>();
+        setSphere(geom0,mesh);
+        setSphere(geom1,mesh);
+        rtcCommitScene (scene0);
+        AssertNoError(device0);
+        rtcCommitScene (scene1);
+        AssertNoError(device1);
+
+        for (size_t j=0; j<1000; j++)
+        {
+          const Vec3fa org = 4.0f*random_Vec3fa()-Vec3fa(2.0f);
+          const Vec3fa dir = normalize(random_Vec3fa()-Vec3fa(0.5f));
+          RTCRayHit ray0 = makeRay(org,dir);
+          RTCRayHit ray1 = ray0;
+          rtcIntersect1(scene0,&ray0);
+          rtcIntersect1(scene1,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+            return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct OverlappingGeometryTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
@@ -1856,6 +2283,146 @@ namespace embree
     }
   };
 
+  struct UpdatePrimitiveRangeTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    UpdatePrimitiveRangeTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* row of triangles that do not share vertices */
+      const unsigned int numTriangles = 1024;
+      std::vector<float> heights(numTriangles,0.0f);
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryBuildQuality(geom,RTC_BUILD_QUALITY_REFIT);
+      Vec3fa* vertices = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),3*numTriangles);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),numTriangles);
+      for (unsigned int i=0; i<numTriangles; i++)
+      {
+        vertices[3*i+0] = Vec3fa(float(i)+0.0f,0.0f,0.0f);
+        vertices[3*i+1] = Vec3fa(float(i)+1.0f,0.0f,0.0f);
+        vertices[3*i+2] = Vec3fa(float(i)+0.0f,0.0f,1.0f);
+        for (unsigned int k=0; k<3; k++) indices[3*i+k] = 3*i+k;
+      }
+      rtcCommitGeometry(geom);
+
+      VerifyScene scene(device,sflags);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      for (unsigned int iter=0; iter<16; iter++)
+      {
+        /* move some range of triangles up or down */
+        const unsigned int begin = (unsigned int)RandomSampler_getInt(sampler) % numTriangles;
+        const unsigned int count = min(numTriangles-begin,1+(unsigned int)RandomSampler_getInt(sampler) % 64);
+        for (unsigned int i=begin; i<begin+count; i++)
+        {
+          heights[i] = 4.0f*(RandomSampler_getFloat(sampler)-0.5f);
+          for (unsigned int k=0; k<3; k++) vertices[3*i+k].y = heights[i];
+        }
+        rtcUpdateGeometryBufferPrimitiveRange(geom,RTC_BUFFER_TYPE_VERTEX,0,begin,count);
+        rtcCommitGeometry(geom);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        for (unsigned int i=0; i<numTriangles; i++)
+        {
+          RTCRayHit ray = makeRay(Vec3fa(float(i)+0.25f,10.0f,0.25f),Vec3fa(0,-1,0));
+          rtcIntersect1(scene,&ray);
+          if (ray.hit.primID != i || std::abs(ray.ray.tfar-(10.0f-heights[i])) > 1E-3f)
+            return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct UpdateInstancesTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    UpdateInstancesTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static void move_instance(RTCGeometry geom, const Vec3fa& pos)
+    {
+      const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, pos.x,pos.y,pos.z };
+      rtcSetGeometryTransform(geom,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+      rtcCommitGeometry(geom);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      VerifyScene sphere(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      sphere.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,10);
+      rtcCommitScene(sphere);
+      AssertNoError(device);
+
+      /* grid of instances where only few instances change per commit */
+      VerifyScene scene(device,sflags);
+      const unsigned int numInstances = 16*16;
+      std::vector<RTCGeometry> instances(numInstances);
+      std::vector<Vec3fa> positions(numInstances);
+      for (unsigned int i=0; i<numInstances; i++)
+      {
+        positions[i] = Vec3fa(4.0f*float(i%16),0.0f,4.0f*float(i/16));
+        instances[i] = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(instances[i],sphere);
+        move_instance(instances[i],positions[i]);
+        rtcAttachGeometryByID(scene,instances[i],i);
+        rtcReleaseGeometry(instances[i]);
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      for (unsigned int i=0; i<32; i++)
+      {
+        /* move instances only vertically to keep them separated, sometimes far to degrade the top-level hierarchy */
+        for (unsigned int j=0; j<4; j++) {
+          const unsigned int k = RandomSampler_getInt(sampler) % numInstances;
+          positions[k].y += (i%8 == 7 ? 64.0f : 2.0f)*(RandomSampler_getFloat(sampler)-0.5f);
+          move_instance(instances[k],positions[k]);
+        }
+
+        /* temporarily disable one instance */
+        const unsigned int disabled = (7*i) % numInstances;
+        rtcDisableGeometry(instances[disabled]);
+        rtcCommitGeometry(instances[disabled]);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        for (unsigned int k=0; k<numInstances; k++)
+        {
+          RTCRayHit ray = makeRay(positions[k]+Vec3fa(0.1f,10,0.1f),Vec3fa(0,-1,0));
+          rtcIntersect1(scene,&ray);
+          const unsigned int expected = k == disabled ? RTC_INVALID_GEOMETRY_ID : k;
+          if (ray.hit.instID[0] != expected)
+            return VerifyApplication::FAILED;
+        }
+
+        rtcEnableGeometry(instances[disabled]);
+        rtcCommitGeometry(instances[disabled]);
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct GarbageGeometryTest : public VerifyApplication::Test
   {
     GarbageGeometryTest (std::string name, int isa)
@@ -2122,6 +2689,48 @@ namespace embree
     }
   };
 
+  struct TessellationCacheStatsTest : public VerifyApplication::Test
+  {
+    TessellationCacheStatsTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_SUBDIVISION_GEOMETRY_SUPPORTED))
+        return VerifyApplication::SKIPPED;
+      
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SUBDIVISION);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,  0, RTC_FORMAT_UINT,   interpolation_quad_indices, 0, sizeof(unsigned int), num_interpolation_quad_faces*4);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,   0, RTC_FORMAT_UINT,   interpolation_quad_faces,   0, sizeof(unsigned int), num_interpolation_quad_faces);
+      std::vector<Vec3fa> vertices(num_interpolation_vertices);
+      for (size_t i=0; i<vertices.size(); i++) vertices[i] = Vec3fa(random_float(),random_float(),random_float());
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0, sizeof(Vec3fa), num_interpolation_vertices);
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+
+      bool passed = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_SIZE) > 0;
+      
+      /* the first lookup has to miss, the second one has to hit the cache */
+      float P[3];
+      const ssize_t misses0 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES);
+      rtcInterpolate1(geom,4,0.5f,0.5f,RTC_BUFFER_TYPE_VERTEX,0,P,nullptr,nullptr,3);
+      const ssize_t misses1 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES);
+      const ssize_t hits1 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS);
+      rtcInterpolate1(geom,4,0.5f,0.5f,RTC_BUFFER_TYPE_VERTEX,0,P,nullptr,nullptr,3);
+      const ssize_t hits2 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS);
+      AssertNoError(device);
+      passed &= misses1 > misses0;
+      passed &= hits2 > hits1;
+
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
   struct InterpolateTrianglesTest : public VerifyApplication::Test
   {
     size_t N;
@@ -2834,55 +3443,203 @@ namespace embree
         child = parent;
       }
 
-      sflags.sflags = sflags.sflags | RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS;
-      
-      RayQueryContext ctx;
-      rtcInitRayQueryContext(&ctx.context);
+      sflags.sflags = sflags.sflags | RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS;
+      
+      RayQueryContext ctx;
+      rtcInitRayQueryContext(&ctx.context);
+
+      RTCIntersectArguments args;
+      rtcInitIntersectArguments(&args);
+      args.context = &ctx.context;
+      args.filter = intersectFilter;
+      args.flags = RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER;
+
+      VerifyScene scene(device, sflags);
+      scene.addGeometry(quality, parent);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      RTCRayHit rays[16];
+      for (unsigned int iy=0; iy<4; iy++) 
+      {
+        for (unsigned int ix=0; ix<4; ix++) 
+        {
+          const int id = iy*4+ix;
+          rays[id] = makeRay(Vec3fa(float(ix)/10.f,float(iy)/10.f,-2.0f),Vec3fa(0,0,1));
+          rays[id].ray.id = id;
+          ctx.numHits[id] = 0;
+        }
+      }
+      IntersectWithMode(imode,ivariant,scene,rays,16,&args);
+      bool passed = true;
+      for (unsigned int iy=0; iy<4; iy++) 
+      {
+        for (unsigned int ix=0; ix<4; ix++) 
+        {
+          const unsigned id = iy*4+ix;
+          passed &= (ctx.numHits[id] > 0);
+          RTCRayHit& ray = rays[id];
+          if (ivariant & VARIANT_INTERSECT)
+            passed &= (ray.hit.geomID != RTC_INVALID_GEOMETRY_ID);
+          else
+            passed &= (ray.ray.tfar == (float)neg_inf);
+        }
+      }
+      assert(passed);
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct InstanceIDStackTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    InstanceIDStackTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static Ref<SceneGraph::Node> createChain(const Vec3fa& pos, unsigned int depth)
+    {
+      Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(depth ? Vec3fa(zero) : pos,1.0f,20);
+      for (unsigned int l=0; l<depth; l++)
+        node = new SceneGraph::TransformNode(l+1 == depth ? AffineSpace3fa::translate(pos) : AffineSpace3fa(one), node);
+      return node;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* every column holds a chain of each depth in front and one of the remaining depth behind it, such that
+       * hits of different depths replace each other in any traversal order */
+      const unsigned int numDepths = RTC_MAX_INSTANCE_LEVEL_COUNT+1;
+      VerifyScene scene(device,sflags);
+      std::vector<unsigned int> front(numDepths), back(numDepths);
+      for (unsigned int d=0; d<numDepths; d++) {
+        front[d] = scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,createChain(Vec3fa(3.0f*float(d),0.0f,0.0f),d));
+        back [d] = scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,createChain(Vec3fa(3.0f*float(d),0.0f,4.0f),numDepths-1-d));
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      RTCRayHit rays[16];
+      for (unsigned int i=0; i<16; i++)
+        rays[i] = makeRay(Vec3fa(3.0f*float(i%numDepths),0.1f,-4.0f),Vec3fa(0,0,1));
+      IntersectWithMode(imode,ivariant,scene,rays,16);
+      AssertNoError(device);
+
+      for (unsigned int i=0; i<16; i++)
+      {
+        const unsigned int d = i%numDepths;
+        const RTCHit& hit = rays[i].hit;
+        if (!(ivariant & VARIANT_INTERSECT)) {
+          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;
+          continue;
+        }
+
+        /* the stack holds the instance of the top-level scene followed by the single instance of each nested scene */
+        const unsigned int geomID = d ? 0 : front[d];
+        if (hit.geomID != geomID || hit.primID == RTC_INVALID_GEOMETRY_ID)
+          return VerifyApplication::FAILED;
+        for (unsigned int l=0; l<d; l++)
+          if (hit.instID[l] != (l ? 0 : front[d])) return VerifyApplication::FAILED;
+        if (d < RTC_MAX_INSTANCE_LEVEL_COUNT && hit.instID[d] != RTC_INVALID_GEOMETRY_ID)
+          return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+  struct InstanceArrayTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    InstanceArrayTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* the sphere has geometry ID 0 in the first and 1 in the second instanced scene */
+      VerifyScene scene0(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      scene0.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,10);
+      rtcCommitScene(scene0);
+      VerifyScene scene1(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      scene1.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,-100,0),1.0f,10);
+      scene1.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,10);
+      rtcCommitScene(scene1);
+      AssertNoError(device);
 
-      RTCIntersectArguments args;
-      rtcInitIntersectArguments(&args);
-      args.context = &ctx.context;
-      args.filter = intersectFilter;
-      args.flags = RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER;
+      /* array of instances alternating between both scenes, followed by a regular instance */
+      const unsigned int numInstances = 15;
+      RTCScene scenes[2] = { scene0, scene1 };
+      RTCGeometry array = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE_ARRAY);
+      rtcSetGeometryInstancedScenes(array,scenes,2);
+      float* xfms = (float*) rtcSetNewGeometryBuffer(array,RTC_BUFFER_TYPE_TRANSFORM,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,12*sizeof(float),numInstances);
+      unsigned int* ids = (unsigned int*) rtcSetNewGeometryBuffer(array,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT,sizeof(unsigned int),numInstances);
+      for (unsigned int i=0; i<numInstances; i++) {
+        const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 3.0f*float(i),0,0 };
+        for (size_t k=0; k<12; k++) xfms[12*i+k] = xfm[k];
+        ids[i] = i%2;
+      }
+      rtcCommitGeometry(array);
+
+      RTCGeometry instance = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(instance,scene0);
+      const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 3.0f*float(numInstances),0,0 };
+      rtcSetGeometryTransform(instance,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+      rtcCommitGeometry(instance);
 
-      VerifyScene scene(device, sflags);
-      scene.addGeometry(quality, parent);
+      VerifyScene scene(device,sflags);
+      rtcAttachGeometryByID(scene,array,0);
+      rtcAttachGeometryByID(scene,instance,1);
+      rtcReleaseGeometry(array);
+      rtcReleaseGeometry(instance);
       rtcCommitScene(scene);
       AssertNoError(device);
 
+      float xfm5[12];
+      rtcGetGeometryTransformEx(array,5,0.0f,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm5);
+      AssertNoError(device);
+      if (xfm5[0] != 1.0f || xfm5[9] != 15.0f || xfm5[10] != 0.0f)
+        return VerifyApplication::FAILED;
+
       RTCRayHit rays[16];
-      for (unsigned int iy=0; iy<4; iy++) 
-      {
-        for (unsigned int ix=0; ix<4; ix++) 
-        {
-          const int id = iy*4+ix;
-          rays[id] = makeRay(Vec3fa(float(ix)/10.f,float(iy)/10.f,-2.0f),Vec3fa(0,0,1));
-          rays[id].ray.id = id;
-          ctx.numHits[id] = 0;
-        }
-      }
-      IntersectWithMode(imode,ivariant,scene,rays,16,&args);
-      bool passed = true;
-      for (unsigned int iy=0; iy<4; iy++) 
+      for (unsigned int i=0; i<16; i++)
+        rays[i] = makeRay(Vec3fa(3.0f*float(i),0.1f,-4.0f),Vec3fa(0,0,1));
+      IntersectWithMode(imode,ivariant,scene,rays,16);
+      AssertNoError(device);
+
+      for (unsigned int i=0; i<16; i++)
       {
-        for (unsigned int ix=0; ix<4; ix++) 
-        {
-          const unsigned id = iy*4+ix;
-          passed &= (ctx.numHits[id] > 0);
-          RTCRayHit& ray = rays[id];
-          if (ivariant & VARIANT_INTERSECT)
-            passed &= (ray.hit.geomID != RTC_INVALID_GEOMETRY_ID);
-          else
-            passed &= (ray.ray.tfar == (float)neg_inf);
+        const RTCHit& hit = rays[i].hit;
+        if (!(ivariant & VARIANT_INTERSECT)) {
+          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;
+          continue;
         }
-      }
-      assert(passed);
-      AssertNoError(device);
 
-      return (VerifyApplication::TestReturnValue) passed;
+        const bool inArray = i < numInstances;
+        if (hit.geomID != (inArray ? i%2 : 0) || hit.primID == RTC_INVALID_GEOMETRY_ID)
+          return VerifyApplication::FAILED;
+        if (hit.instID[0] != (inArray ? 0 : 1) || hit.instPrimID[0] != (inArray ? i : 0))
+          return VerifyApplication::FAILED;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+        if (hit.instID[1] != RTC_INVALID_GEOMETRY_ID)
+          return VerifyApplication::FAILED;
+#endif
+      }
+      return VerifyApplication::PASSED;
     }
   };
-    
+#endif
+
   struct InactiveRaysTest : public VerifyApplication::IntersectTest
   {
     SceneFlags sflags;
@@ -3559,9 +4316,51 @@ namespace embree
   {
     SceneFlags sflags; 
     std::string tri_accel;
+    size_t K;
 
-    PointQueryTest (std::string name, int isa, SceneFlags sflags, std::string tri_accel = "")
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), tri_accel(tri_accel) {}
+    PointQueryTest (std::string name, int isa, SceneFlags sflags, std::string tri_accel = "", size_t K = 1)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), tri_accel(tri_accel), K(K) {}
+
+    struct UserData
+    {
+      Vec3f* vertices;
+      Triangle* triangles;
+      Vec3f result;
+      unsigned int primID = RTC_INVALID_GEOMETRY_ID;
+    };
+
+    static bool queryFunc(RTCPointQueryFunctionArguments* args)
+    {
+      UserData* data = (UserData*)args->userPtr;
+      // get triangle info
+      Triangle const& t = data->triangles[args->primID];
+      Vec3f const& v0 = data->vertices[t.v0];
+      Vec3f const& v1 = data->vertices[t.v1];
+      Vec3f const& v2 = data->vertices[t.v2];
+      
+      // determine closest point on triangle
+      const Vec3f q(args->query->x, args->query->y, args->query->z);
+      const Vec3f p = closestPointTriangle(q, v0, v1, v2);
+      const float d = distance(q, p);
+
+      if (d < args->query->radius) {
+        args->query->radius = d;
+        data->result = p;
+        data->primID = args->primID;
+        return true;
+      }
+      return false; 
+    }
+
+    /* packets of different width have different SOA layouts, thus lanes have to be copied */
+    template<typename PointQueryK>
+    static void copyPointQuery(PointQueryK& dst, const RTCPointQuery16& src, size_t K)
+    {
+      for (size_t k = 0; k < K; ++k) {
+        dst.x[k] = src.x[k]; dst.y[k] = src.y[k]; dst.z[k] = src.z[k];
+        dst.time[k] = src.time[k]; dst.radius[k] = src.radius[k];
+      }
+    }
 
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
@@ -3593,56 +4392,61 @@ namespace embree
       rtcCommitScene (scene);
       AssertNoError(device);
 
-      struct UserData
-      {
-        Vec3f* vertices;
-        Triangle* triangles;
-        Vec3f result;
-        unsigned int primID = RTC_INVALID_GEOMETRY_ID;
-      };
-
-      for (int i = 0; i < 64; ++i)
+      for (int i0 = 0; i0 < 64; i0 += (int)K)
       {
-        RTCPointQuery query;
-        query.x = 0.25f;
-        query.y = 0.75f;
-        query.z = -0.25f + i * 0.5f;
-        query.time = 0.f;
-        query.radius = inf;
+        UserData data[16];
+        void* userPtrN[16];
+        __aligned(64) int valid[16];
+        __aligned(64) RTCPointQuery16 query16;
 
-        UserData data;
-        data.vertices  = vertices;
-        data.triangles = triangles;
+        for (size_t k = 0; k < K; ++k)
+        {
+          const int i = i0 + (int)k;
+          query16.x[k] = 0.25f;
+          query16.y[k] = 0.75f;
+          query16.z[k] = -0.25f + i * 0.5f;
+          query16.time[k] = 0.f;
+          query16.radius[k] = inf;
+          
+          data[k].vertices  = vertices;
+          data[k].triangles = triangles;
+          userPtrN[k] = &data[k];
+          valid[k] = -1;
+        }
 
         RTCPointQueryContext context;
         rtcInitPointQueryContext(&context);
-        rtcPointQuery(scene, &query, &context, [](RTCPointQueryFunctionArguments* args) -> bool
-        {
-          UserData* data = (UserData*)args->userPtr;
-          // get triangle info
-          Triangle const& t = data->triangles[args->primID];
-          Vec3f const& v0 = data->vertices[t.v0];
-          Vec3f const& v1 = data->vertices[t.v1];
-          Vec3f const& v2 = data->vertices[t.v2];
-          
-          // determine closest point on triangle
-          const Vec3f q(args->query->x, args->query->y, args->query->z);
-          const Vec3f p = closestPointTriangle(q, v0, v1, v2);
-          const float d = distance(q, p);
-
-          if (d < args->query->radius) {
-            args->query->radius = d;
-            data->result = p;
-            data->primID = args->primID;
-            return true;
-          }
-          return false; 
-        }, &data);
+        switch (K) {
+        case 1: {
+          RTCPointQuery query;
+          query.x = query16.x[0]; query.y = query16.y[0]; query.z = query16.z[0];
+          query.time = query16.time[0]; query.radius = query16.radius[0];
+          rtcPointQuery(scene, &query, &context, queryFunc, &data[0]);
+          break;
+        }
+        case  4: {
+          __aligned(16) RTCPointQuery4 query4;
+          copyPointQuery(query4, query16, 4);
+          rtcPointQuery4(valid, scene, &query4, &context, queryFunc, userPtrN);
+          break;
+        }
+        case  8: {
+          __aligned(32) RTCPointQuery8 query8;
+          copyPointQuery(query8, query16, 8);
+          rtcPointQuery8(valid, scene, &query8, &context, queryFunc, userPtrN);
+          break;
+        }
+        case 16: rtcPointQuery16(valid, scene, (RTCPointQuery16*)&query16, &context, queryFunc, userPtrN); break;
+        }
 
-        if ((int)data.primID != i/2) return VerifyApplication::FAILED;
-        if (abs(data.result.x- 0.25f) > 1e-4f)        return VerifyApplication::FAILED;
-        if (abs(data.result.y- 0.75f) > 1e-4f)        return VerifyApplication::FAILED;
-        if (abs(data.result.z- (float)(i/2)) > 1e-4f) return VerifyApplication::FAILED;
+        for (size_t k = 0; k < K; ++k)
+        {
+          const int i = i0 + (int)k;
+          if ((int)data[k].primID != i/2) return VerifyApplication::FAILED;
+          if (abs(data[k].result.x- 0.25f) > 1e-4f)        return VerifyApplication::FAILED;
+          if (abs(data[k].result.y- 0.75f) > 1e-4f)        return VerifyApplication::FAILED;
+          if (abs(data[k].result.z- (float)(i/2)) > 1e-4f) return VerifyApplication::FAILED;
+        }
         AssertNoError(device);
       }
 
@@ -4062,6 +4866,124 @@ namespace embree
     }
   };
   
+  struct MultiHitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    MultiHitTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    struct Hit
+    {
+      Hit (float t, unsigned int geomID, unsigned int primID)
+        : t(t), geomID(geomID), primID(primID) {}
+
+      __forceinline friend bool operator < (const Hit& a, const Hit& b) {
+        if (a.t != b.t) return a.t < b.t;
+        if (a.geomID != b.geomID) return a.geomID < b.geomID;
+        return a.primID < b.primID;
+      }
+
+      __forceinline friend bool operator == (const Hit& a, const Hit& b) {
+        return a.t == b.t && a.geomID == b.geomID && a.primID == b.primID;
+      }
+
+      float t;
+      unsigned int geomID;
+      unsigned int primID;
+    };
+
+    struct RayQueryContext
+    {
+      RTCRayQueryContext context;
+      std::vector<Hit>* hits;
+    };
+
+    /* gathers all hits the way the next_hit tutorial does */
+    static void gatherAllHits(const RTCFilterFunctionNArguments* args)
+    {
+      RTCRay* ray = (RTCRay*) args->ray;
+      RTCHit* hit = (RTCHit*) args->hit;
+      ((RayQueryContext*)args->context)->hits->push_back(Hit(ray->tfar,hit->geomID,hit->primID));
+      args->valid[0] = 0;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* nested spheres produce up to 8 hits along each ray */
+      VerifyScene scene(device,SceneFlags(RTCSceneFlags(sflags.sflags | RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS),sflags.qflags));
+      for (size_t i=0; i<4; i++)
+        scene.addGeometry(quality,SceneGraph::createTriangleSphere(zero,0.4f+0.2f*float(i),50));
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      const unsigned int maxHitsList[] = { 1, 3, 16 };
+      float t[16];
+      RTCHit hits[16];
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 4.0f*random_Vec3fa()-Vec3fa(2.0f);
+        const Vec3fa dir = normalize(random_Vec3fa()-Vec3fa(0.5f)-org);
+
+        /* reference gathers all hits using a filter function */
+        std::vector<Hit> ref;
+        RayQueryContext context;
+        rtcInitRayQueryContext(&context.context);
+        context.hits = &ref;
+        RTCIntersectArguments args;
+        rtcInitIntersectArguments(&args);
+        args.context = &context.context;
+        args.filter = gatherAllHits;
+        args.flags = RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER;
+        RTCRayHit ray0 = makeRay(org,dir);
+        rtcIntersect1(scene,&ray0,&args);
+        std::sort(ref.begin(),ref.end());
+        ref.erase(std::unique(ref.begin(),ref.end()),ref.end());
+
+        for (unsigned int maxHits : maxHitsList)
+        {
+          RTCMultiHit multiHit;
+          multiHit.maxHits = maxHits;
+          multiHit.numHits = 0;
+          multiHit.t = t;
+          multiHit.hits = hits;
+          RTCIntersectArguments margs;
+          rtcInitIntersectArguments(&margs);
+          margs.multiHit = &multiHit;
+          RTCRayHit ray1 = makeRay(org,dir);
+          rtcIntersect1(scene,&ray1,&margs);
+          AssertNoError(device);
+
+          if (multiHit.numHits != std::min(size_t(maxHits),ref.size()))
+            return VerifyApplication::FAILED;
+
+          std::vector<Hit> found;
+          for (unsigned int j=0; j<multiHit.numHits; j++) {
+            if (j && t[j-1] > t[j]) return VerifyApplication::FAILED;
+            found.push_back(Hit(t[j],hits[j].geomID,hits[j].primID));
+          }
+          std::sort(found.begin(),found.end());
+          if (!std::equal(found.begin(),found.end(),ref.begin()))
+            return VerifyApplication::FAILED;
+
+          /* the ray reports the closest hit */
+          if (ref.size() && (ray1.ray.tfar != ref[0].t || ray1.hit.geomID != hits[0].geomID || ray1.hit.primID != hits[0].primID))
+            return VerifyApplication::FAILED;
+          if (ref.empty() && ray1.hit.geomID != RTC_INVALID_GEOMETRY_ID)
+            return VerifyApplication::FAILED;
+        }
+      }
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
@@ -5117,6 +6039,20 @@ namespace embree
         }
         break;
       }
+      case MODE_INTERSECT1M: 
+      {
+        vector_t<RTCRayHit,aligned_allocator<RTCRayHit,16>> rays((x1-x0)*(y1-y0));
+        for (size_t y=y0, i=0; y<y1; y++) {
+          for (size_t x=x0; x<x1; x++, i++) {
+            rays[i] = fastMakeRay(zero,Vec3f(float(x)*rcpWidth,1,float(y)*rcpHeight));
+          }
+        }
+        switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+        case VARIANT_INTERSECT: rtcIntersect1M(*scene,rays.data(),(unsigned int)rays.size(),sizeof(RTCRayHit),&args); break;
+        case VARIANT_OCCLUDED : rtcOccluded1M (*scene,(RTCRay*)rays.data(),(unsigned int)rays.size(),sizeof(RTCRayHit),(RTCOccludedArguments*)&args); break;
+        }
+        break;
+      }
       default: break;
       }
     }
@@ -5142,13 +6078,14 @@ namespace embree
     IntersectMode imode;
     IntersectVariant ivariant;
     size_t numPhi;
+    std::string config;
     RTCDeviceRef device;
     Ref<VerifyScene> scene;
     static const size_t numRays = 16*1024*1024;
     static const size_t deltaRays = 1024;
     
-    IncoherentRaysBenchmark (std::string name, int isa, GeometryType gtype, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant, size_t numPhi)
-      : ParallelIntersectBenchmark(name,isa,numRays,deltaRays), gtype(gtype), sflags(sflags), quality(quality), imode(imode), ivariant(ivariant), numPhi(numPhi), device(nullptr)  {}
+    IncoherentRaysBenchmark (std::string name, int isa, GeometryType gtype, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant, size_t numPhi, std::string config = "")
+      : ParallelIntersectBenchmark(name,isa,numRays,deltaRays), gtype(gtype), sflags(sflags), quality(quality), imode(imode), ivariant(ivariant), numPhi(numPhi), config(config), device(nullptr)  {}
 
     size_t setNumPrimitives(size_t N) 
     { 
@@ -5161,7 +6098,7 @@ namespace embree
       if (!ParallelIntersectBenchmark::setup(state))
         return false;
 
-      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa) + config;
       device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
       rtcSetDeviceErrorFunction(device,errorHandler,nullptr);
@@ -5260,6 +6197,18 @@ namespace embree
         }
         break;
       }
+      case MODE_INTERSECT1M: 
+      {
+        vector_t<RTCRayHit,aligned_allocator<RTCRayHit,16>> rays(dn);
+        for (size_t j=0; j<dn; j++) {
+          fastMakeRay(rays[j],zero,sampler);
+        }
+        switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+        case VARIANT_INTERSECT: rtcIntersect1M(*scene,rays.data(),(unsigned int)dn,sizeof(RTCRayHit),&args); break;
+        case VARIANT_OCCLUDED : rtcOccluded1M (*scene,(RTCRay*)rays.data(),(unsigned int)dn,sizeof(RTCRayHit),(RTCOccludedArguments*)&args); break;
+        }
+        break;
+      }
       default: break;
       }
     }
@@ -5273,6 +6222,133 @@ namespace embree
     }
   };
 
+  struct PointQueryBenchmark : public ParallelIntersectBenchmark
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+    size_t K;
+    size_t numTriangles;
+    RTCDeviceRef device;
+    RTCScene scene;
+    std::vector<Vec3f> vertices;
+    std::vector<Triangle> triangles;
+    static const size_t numQueries = 1024*1024;
+    static const size_t blockSize = 1024;
+
+    PointQueryBenchmark (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, size_t K, size_t numTriangles)
+      : ParallelIntersectBenchmark(name,isa,numQueries,blockSize), sflags(sflags), quality(quality), K(K), numTriangles(numTriangles), scene(nullptr) {}
+
+    struct UserData
+    {
+      const Vec3f* vertices;
+      const Triangle* triangles;
+    };
+
+    static bool queryFunc(RTCPointQueryFunctionArguments* args)
+    {
+      const UserData* data = (const UserData*)args->userPtr;
+      Triangle const& t = data->triangles[args->primID];
+      const Vec3f q(args->query->x, args->query->y, args->query->z);
+      const Vec3f p = closestPointTriangle(q, data->vertices[t.v0], data->vertices[t.v1], data->vertices[t.v2]);
+      const float d = distance(q, p);
+      if (d < args->query->radius) {
+        args->query->radius = d;
+        return true;
+      }
+      return false;
+    }
+
+    bool setup(VerifyApplication* state) 
+    {
+      if (!ParallelIntersectBenchmark::setup(state))
+        return false;
+
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      rtcSetDeviceErrorFunction(device,errorHandler,nullptr);
+
+      /* small random triangles inside the unit cube */
+      RandomSampler sampler;
+      RandomSampler_init(sampler, 0);
+      vertices.resize(3*numTriangles);
+      triangles.resize(numTriangles);
+      for (size_t i=0; i<numTriangles; i++) {
+        const Vec3f c(RandomSampler_getFloat(sampler),RandomSampler_getFloat(sampler),RandomSampler_getFloat(sampler));
+        for (size_t j=0; j<3; j++)
+          vertices[3*i+j] = c + 0.01f*Vec3f(RandomSampler_getFloat(sampler),RandomSampler_getFloat(sampler),RandomSampler_getFloat(sampler));
+        triangles[i] = Triangle(unsigned(3*i+0),unsigned(3*i+1),unsigned(3*i+2));
+      }
+
+      scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,sflags.sflags);
+      rtcSetSceneBuildQuality(scene,quality);
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryBuildQuality(geom,quality);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0, sizeof(Vec3f), vertices.size());
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX , 0, RTC_FORMAT_UINT3 , triangles.data(), 0, sizeof(Triangle), triangles.size());
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+      return true;
+    }
+
+    void render_block(size_t i, size_t n)
+    {
+      UserData data;
+      data.vertices = vertices.data();
+      data.triangles = triangles.data();
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler, (int)i);
+
+      RTCPointQueryContext context;
+      rtcInitPointQueryContext(&context);
+
+      void* userPtrN[16];
+      __aligned(64) int valid[16];
+      for (size_t k=0; k<16; k++) {
+        userPtrN[k] = &data;
+        valid[k] = -1;
+      }
+
+      for (size_t j=0; j<n; j+=K)
+      {
+        __aligned(64) RTCPointQuery16 query16;
+        for (size_t k=0; k<K; k++) {
+          query16.x[k] = RandomSampler_getFloat(sampler);
+          query16.y[k] = RandomSampler_getFloat(sampler);
+          query16.z[k] = RandomSampler_getFloat(sampler);
+          query16.time[k] = 0.0f;
+          query16.radius[k] = inf;
+        }
+
+        switch (K) {
+        case 1: {
+          RTCPointQuery query;
+          query.x = query16.x[0]; query.y = query16.y[0]; query.z = query16.z[0];
+          query.time = 0.0f; query.radius = inf;
+          rtcPointQuery(scene,&query,&context,queryFunc,&data);
+          break;
+        }
+        case  4: rtcPointQuery4 (valid,scene,(RTCPointQuery4*) &query16,&context,queryFunc,userPtrN); break;
+        case  8: rtcPointQuery8 (valid,scene,(RTCPointQuery8*) &query16,&context,queryFunc,userPtrN); break;
+        case 16: rtcPointQuery16(valid,scene,(RTCPointQuery16*)&query16,&context,queryFunc,userPtrN); break;
+        }
+      }
+    }
+
+    virtual void cleanup(VerifyApplication* state) 
+    {
+      if (scene) rtcReleaseScene(scene);
+      scene = nullptr;
+      device = nullptr;
+      ParallelIntersectBenchmark::cleanup(state);
+    }
+  };
+
   static std::atomic<ssize_t> create_geometry_bytes_used(0);
 
   struct CreateGeometryBenchmark : public VerifyApplication::Benchmark
@@ -5469,6 +6545,8 @@ namespace embree
     intersectModes.push_back(MODE_INTERSECT4);
     intersectModes.push_back(MODE_INTERSECT8);
     intersectModes.push_back(MODE_INTERSECT16);
+    intersectModes.push_back(MODE_INTERSECT1M);
+    intersectModes.push_back(MODE_INTERSECTNp);
         
     /* create a list of all intersect variants for each intersect mode */
     intersectVariants.push_back(VARIANT_INTERSECT_COHERENT);
@@ -5568,7 +6646,60 @@ namespace embree
       for (auto sflags : sceneFlags) 
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
       groups.pop();
-      
+
+      push(new TestGroup("commit_async",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new CommitSceneAsyncTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("bvh_reorder",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new BVHReorderTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("bvh_collapse",true,true));
+      for (auto sflags : sceneFlags) {
+        groups.top()->add(new BVHCollapseTest(to_string(sflags),isa,sflags,""));
+        groups.top()->add(new BVHCollapseTest(to_string(sflags)+"_presplits",isa,sflags,",presplits=1"));
+      }
+      groups.pop();
+
+      push(new TestGroup("ploc",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new TriangleBuilderTest(to_string(sflags),isa,sflags,"ploc",20));
+      groups.pop();
+
+      push(new TestGroup("lbvh",true,true));
+      for (auto sflags : sceneFlags) {
+        groups.top()->add(new TriangleBuilderTest(to_string(sflags),isa,sflags,"lbvh",20));
+        groups.top()->add(new TriangleBuilderTest(to_string(sflags)+"_treelets",isa,sflags,"trbvh",20));
+      }
+      groups.pop();
+
+      push(new TestGroup("save_load_bvh",true,true));
+      for (auto sflags : sceneFlags)
+        if (!(sflags.sflags & RTC_SCENE_FLAG_DYNAMIC))
+          groups.top()->add(new SaveLoadBVHTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("memory_budget",true,true));
+      for (auto sflags : sceneFlags)
+        if (!(sflags.sflags & (RTC_SCENE_FLAG_COMPACT | RTC_SCENE_FLAG_ROBUST)))
+          groups.top()->add(new MemoryBudgetTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("alloc_retention",true,true));
+      for (auto sflags : sceneFlagsDynamic) {
+        groups.top()->add(new AllocRetentionTest(to_string(sflags)+"_retain",isa,sflags,",alloc_retain_blocks=1"));
+        groups.top()->add(new AllocRetentionTest(to_string(sflags)+"_double_buffer",isa,sflags,",alloc_double_buffer=1"));
+      }
+      groups.pop();
+
+      push(new TestGroup("multi_hit",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new MultiHitTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
       push(new TestGroup("overlapping_primitives",true,false));
       for (auto sflags : sceneFlags)
         groups.top()->add(new OverlappingGeometryTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,clamp(int(intensity*10000),1000,100000)));
@@ -5604,6 +6735,8 @@ namespace embree
             }
           }
         }
+        groups.top()->add(new UpdatePrimitiveRangeTest("primitive_range."+to_string(sflags),isa,sflags));
+        groups.top()->add(new UpdateInstancesTest("instances."+to_string(sflags),isa,sflags));
       }
       groups.pop();
 
@@ -5656,6 +6789,8 @@ namespace embree
         groups.top()->add(new InterpolateHairTest(std::to_string((long long)(s)),isa,s));
       groups.pop();
 
+      groups.top()->add(new TessellationCacheStatsTest("tessellation_cache_stats",isa));
+
       groups.pop();
       
       /**************************************************************************/
@@ -5733,6 +6868,18 @@ namespace embree
             for (auto ivariant : intersectVariants)
               if (has_variant(imode,ivariant)) 
                 groups.top()->add(new InstancingTest("instancing."+to_string(sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,true,imode,ivariant));
+        for (auto sflags : sceneFlags)
+          for (auto imode : intersectModes)
+            for (auto ivariant : intersectVariants)
+              if (has_variant(imode,ivariant))
+                groups.top()->add(new InstanceIDStackTest("instance_id_stack."+to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        for (auto sflags : sceneFlags)
+          for (auto imode : intersectModes)
+            for (auto ivariant : intersectVariants)
+              if (has_variant(imode,ivariant))
+                groups.top()->add(new InstanceArrayTest("instance_array."+to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+#endif
       groups.pop();
       
       push(new TestGroup("inactive_rays",true,true));
@@ -5868,8 +7015,12 @@ namespace embree
           groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags,"bvh8.triangle4i"));
           groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags,"qbvh8.triangle4"));
           groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags,"qbvh8.triangle4i"));
+          groups.top()->add(new PointQueryTest(to_string(sflags)+".packet8",isa,sflags,"qbvh8.triangle4i",8));
         }
         groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags));
+        groups.top()->add(new PointQueryTest(to_string(sflags)+".packet4", isa,sflags,"",4));
+        groups.top()->add(new PointQueryTest(to_string(sflags)+".packet8", isa,sflags,"",8));
+        groups.top()->add(new PointQueryTest(to_string(sflags)+".packet16",isa,sflags,"",16));
       }
 
       groups.top()->add(new PointQueryMotionBlurTest("point_query_motion_blur_aligned_node",isa,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM),"bvh4.triangle4i"));
@@ -5931,6 +7082,8 @@ namespace embree
       benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT8,VARIANT_OCCLUDED));
       benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT16,VARIANT_INTERSECT));
       benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT16,VARIANT_OCCLUDED));
+      benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT1M,VARIANT_INTERSECT));
+      benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT1M,VARIANT_OCCLUDED));
 
       GeometryType benchmark_gtypes[] = { 
         TRIANGLE_MESH, 
@@ -5962,6 +7115,23 @@ namespace embree
             groups.top()->add(new IncoherentRaysBenchmark("incoherent."+to_string(gtype)+"_1000k."+to_string(sflags.first,imode.first,imode.second),
                                                           isa,gtype,sflags.first,sflags.second,imode.first,imode.second,501));
 
+      /* compares against the incoherent benchmarks above to measure NUMA local block placement */
+      for (auto sflags : benchmark_sflags_quality) 
+        for (auto imode : benchmark_imodes_ivariants)
+          groups.top()->add(new IncoherentRaysBenchmark("incoherent_numa."+to_string(TRIANGLE_MESH)+"_1000k."+to_string(sflags.first,imode.first,imode.second),
+                                                        isa,TRIANGLE_MESH,sflags.first,sflags.second,imode.first,imode.second,501,",numa=1"));
+
+      /* compares against the incoherent benchmarks above to measure the treelet layout of BVH nodes */
+      for (auto sflags : benchmark_sflags_quality) 
+        for (auto imode : benchmark_imodes_ivariants)
+          groups.top()->add(new IncoherentRaysBenchmark("incoherent_reorder."+to_string(TRIANGLE_MESH)+"_1000k."+to_string(sflags.first,imode.first,imode.second),
+                                                        isa,TRIANGLE_MESH,sflags.first,sflags.second,imode.first,imode.second,501,",bvh_reorder=1"));
+
+      for (auto sflags : benchmark_sflags_quality)
+        for (size_t K : { 1, 4, 8, 16 })
+          groups.top()->add(new PointQueryBenchmark("point_query.triangles_100k.packet"+std::to_string(K)+"."+to_string(sflags.first,sflags.second),
+                                                    isa,sflags.first,sflags.second,K,100000));
+
       std::vector<std::pair<SceneFlags,RTCBuildQuality>> benchmark_create_sflags_quality;
       benchmark_create_sflags_quality.push_back(std::make_pair(SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM),RTC_BUILD_QUALITY_MEDIUM));
       benchmark_create_sflags_quality.push_back(std::make_pair(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,RTC_BUILD_QUALITY_LOW),RTC_BUILD_QUALITY_LOW));